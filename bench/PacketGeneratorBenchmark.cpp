@@ -0,0 +1,155 @@
+#include "../src/AllocationCounter.hpp"
+#include "../src/NullPrinter.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/PacketValidator.hpp"
+#include "../src/Utils.hpp"
+#include "../src/WireFormat.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace Logi;
+
+namespace{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto s_minDuration = std::chrono::milliseconds(300);
+    constexpr size_t s_maxIterations = 1000000;
+
+    volatile size_t g_sink{0};
+
+    /// Runs the function repeatedly and prints the time per call, per packet,
+    /// the throughput and the allocations per call.
+    ///
+    /// \param name The name of the benchmark.
+    /// \param bytes The number of input bytes processed per call.
+    /// \param items The number of packets (or operations) per call.
+    template<typename Function>
+    void run(const std::string& name, size_t bytes, size_t items, Function&& function)
+    {
+        size_t iterations = 0;
+        AllocationStats allocations;
+        Clock::duration elapsed{};
+
+        while (elapsed < s_minDuration && iterations < s_maxIterations)
+        {
+            AllocationScope scope;
+            auto start = Clock::now();
+            function();
+            elapsed += Clock::now() - start;
+            allocations.allocations += scope.stats().allocations;
+            allocations.bytes += scope.stats().bytes;
+            iterations++;
+        }
+
+        auto nsPerCall = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+        auto nsPerItem = items ? nsPerCall / items : 0.0;
+        auto bytesPerSecond = bytes ? bytes / (nsPerCall * 1e-9) : 0.0;
+
+        std::printf("%-32s %10zu %14.1f %12.2f %12.1f %12.1f %14.1f\n",
+            name.c_str(), iterations, nsPerCall, nsPerItem, bytesPerSecond / (1024 * 1024),
+            static_cast<double>(allocations.allocations) / iterations,
+            static_cast<double>(allocations.bytes) / iterations);
+    }
+
+    std::string sizeName(size_t size)
+    {
+        if (size >= 1024 * 1024)
+            return std::to_string(size / (1024 * 1024)) + "MB";
+        if (size >= 1024)
+            return std::to_string(size / 1024) + "KB";
+        return std::to_string(size) + "B";
+    }
+
+    size_t packetCount(size_t size)
+    {
+        return (size + PacketGenerator::s_maxDataBytes - 1) / PacketGenerator::s_maxDataBytes + 2;
+    }
+}
+
+int main()
+{
+    const std::vector<size_t> sizes{1, 1024, 1024 * 1024, 100 * 1024 * 1024};
+
+    NullPrinter printer;
+    PacketGenerator generator{52, printer};
+
+    std::printf("%-32s %10s %14s %12s %12s %12s %14s\n", "benchmark", "iterations", "ns/call", "ns/packet", "MB/s", "allocs/call", "bytes/call");
+
+    for (auto size : sizes)
+    {
+        auto buffer = generateRandomBuffer(size);
+        run("createPackets/" + sizeName(size), size, packetCount(size), [&] {
+            auto packets = generator.createPackets(buffer, {});
+            g_sink = g_sink + packets.size();
+        });
+    }
+
+    {
+        size_t size = 100 * 1024 * 1024;
+        auto buffer = generateRandomBuffer(size);
+        run("createPackets/parallel/" + sizeName(size), size, packetCount(size), [&] {
+            auto packets = generator.createPackets(buffer.data(), buffer.size(), {}, 0u);
+            g_sink = g_sink + packets.size();
+        });
+    }
+
+    for (auto size : {size_t{1024}, size_t{1024 * 1024}})
+    {
+        auto buffer = generateRandomBuffer(size);
+        std::vector<std::byte> arena(packetCount(size) * sizeof(PacketVariant));
+        run("createPackets/pmr/" + sizeName(size), size, packetCount(size), [&] {
+            std::pmr::monotonic_buffer_resource resource{arena.data(), arena.size()};
+            auto packets = generator.createPackets(buffer.data(), buffer.size(), {}, &resource);
+            g_sink = g_sink + packets.size();
+        });
+    }
+
+    for (auto size : {size_t{1}, size_t{1024}, size_t{1024 * 1024}})
+    {
+        auto buffer = generateRandomBuffer(size);
+        auto packets = generator.createPackets(buffer, {});
+        run("printPackets/" + sizeName(size), size, packets.size(), [&] {
+            generator.printPackets(packets);
+        });
+    }
+
+    for (auto size : {size_t{1024}, size_t{1024 * 1024}})
+    {
+        run("generateRandomBuffer/" + sizeName(size), size, 0, [&] {
+            auto buffer = generateRandomBuffer(size);
+            g_sink = g_sink + buffer.size();
+        });
+    }
+
+    for (auto size : {size_t{1024 * 1024}, size_t{100 * 1024 * 1024}})
+    {
+        auto serialized = generator.serialize(generateRandomBuffer(size), {});
+        const std::byte* packets = serialized.data() + startPacketWireSize;
+        auto packetsSize = serialized.size() - startPacketWireSize - stopPacketWireSize;
+        PacketValidator validator{52};
+        run("validatePackets/" + sizeName(size), packetsSize, packetCount(size) - 2, [&] {
+            g_sink = g_sink + validator.findInvalidPacket(packets, packetsSize).value_or(0);
+        });
+    }
+
+    constexpr size_t fieldReads = 1 << 16;
+    run("readField16", 0, fieldReads, [&] {
+        size_t sum = 0;
+        for (size_t i = 0; i < fieldReads; i++)
+            sum += readField16(i & 0xFF, (i >> 8) & 0xFF, i & 1);
+        g_sink = g_sink + sum;
+    });
+
+    run("readField32", 0, fieldReads, [&] {
+        size_t sum = 0;
+        for (size_t i = 0; i < fieldReads; i++)
+            sum += readField32(i & 0xFF, (i >> 8) & 0xFF, (i >> 4) & 0xFF, (i >> 2) & 0xFF, i & 1);
+        g_sink = g_sink + sum;
+    });
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> g_allocations{0};
+    std::atomic<size_t> g_bytes{0};
+}
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace Logi
+{
+    AllocationStats allocationStats()
+    {
+        AllocationStats stats;
+        stats.allocations = g_allocations.load(std::memory_order_relaxed);
+        stats.bytes = g_bytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    AllocationScope::AllocationScope()
+        : m_start{allocationStats()}
+    {}
+
+    AllocationStats AllocationScope::stats() const
+    {
+        auto now = allocationStats();
+        AllocationStats stats;
+        stats.allocations = now.allocations - m_start.allocations;
+        stats.bytes = now.bytes - m_start.bytes;
+        return stats;
+    }
+
+} // namespace Logi
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Logi
+{
+    struct AllocationStats
+    {
+        size_t allocations{};
+        size_t bytes{};
+    };
+
+    /// Returns the heap allocations performed by the process so far.
+    ///
+    /// Counting is opt-in: the global operator new is only replaced when the
+    /// PacketGeneratorAllocationCounter library is linked into the executable.
+    AllocationStats allocationStats();
+
+    /// Measures the heap allocations performed during its lifetime.
+    class AllocationScope
+    {
+    public:
+
+        AllocationScope();
+
+        /// Returns the allocations performed since the scope was created.
+        AllocationStats stats() const;
+
+    private:
+
+        AllocationStats m_start;
+    };
+
+} // namespace Logi
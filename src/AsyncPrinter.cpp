@@ -0,0 +1,172 @@
+#include "AsyncPrinter.hpp"
+#include <chrono>
+
+namespace Logi
+{
+    namespace{
+        /// Spins for a while, then sleeps, while waiting on the other thread.
+        class Backoff
+        {
+        public:
+            void wait()
+            {
+                if (spinning())
+                {
+                    m_spins++;
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+
+            bool spinning() const { return m_spins < 64; }
+            void reset() { m_spins = 0; }
+
+        private:
+            unsigned int m_spins{0};
+        };
+
+        size_t roundUpToPowerOfTwo(size_t value)
+        {
+            size_t result = 1;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+    }
+
+    AsyncPrinter::AsyncPrinter(IPrinter& sink, size_t capacity, OverflowPolicy policy)
+        : m_sink{sink}
+        , m_policy{policy}
+        , m_slots(roundUpToPowerOfTwo(capacity))
+        , m_mask{m_slots.size() - 1}
+    {
+        m_batch.records.reserve(m_slots.size());
+        m_thread = std::thread{&AsyncPrinter::run, this};
+    }
+
+    AsyncPrinter::~AsyncPrinter()
+    {
+        m_stop.store(true);
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_wakeUp.notify_one();
+        }
+        m_thread.join();
+    }
+
+    void AsyncPrinter::print(std::string_view str)
+    {
+        if (tryPush(str))
+            return;
+
+        if (m_policy == OverflowPolicy::Drop)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Backoff backoff;
+        while (!tryPush(str))
+        {
+            backoff.wait();
+        }
+    }
+
+    void AsyncPrinter::printBatch(const PrintBatch& batch)
+    {
+        for (auto record : batch.records)
+        {
+            print(record);
+        }
+    }
+
+    void AsyncPrinter::flush()
+    {
+        Backoff backoff;
+        while (m_tail.load(std::memory_order_acquire) != m_head.load(std::memory_order_relaxed))
+        {
+            backoff.wait();
+        }
+    }
+
+    size_t AsyncPrinter::dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    bool AsyncPrinter::tryPush(std::string_view str)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_slots.size())
+            return false;  // full
+
+        m_slots[head & m_mask].assign(str);  // reuses the slot capacity
+        m_head.store(head + 1);
+
+        // Ordered after the head store, so either the writer thread sees the
+        // record before sleeping or it is seen waiting here
+        if (m_writerWaiting.load())
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_wakeUp.notify_one();
+        }
+        return true;
+    }
+
+    void AsyncPrinter::run()
+    {
+        Backoff backoff;
+        while (true)
+        {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            auto head = m_head.load(std::memory_order_acquire);
+
+            if (tail == head)
+            {
+                // Only stop once everything pushed before the stop request was written
+                if (m_stop.load(std::memory_order_acquire) && m_head.load(std::memory_order_acquire) == tail)
+                    break;
+
+                if (backoff.spinning())
+                    backoff.wait();
+                else
+                    waitForRecords(tail);
+                continue;
+            }
+            backoff.reset();
+
+            // Join the queued records so that the sink can write them at once
+            m_text.clear();
+            for (auto slot = tail; slot != head; slot++)
+            {
+                m_text.append(m_slots[slot & m_mask]).push_back('\n');
+            }
+
+            m_batch.text = m_text;
+            m_batch.records.clear();
+            size_t offset = 0;
+            for (auto slot = tail; slot != head; slot++)
+            {
+                auto size = m_slots[slot & m_mask].size();
+                m_batch.records.emplace_back(m_text.data() + offset, size);
+                offset += size + 1;
+            }
+            m_sink.printBatch(m_batch);
+
+            m_tail.store(head, std::memory_order_release);
+        }
+    }
+
+    void AsyncPrinter::waitForRecords(size_t tail)
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_writerWaiting.store(true);
+        if (m_head.load() == tail && !m_stop.load())
+            m_wakeUp.wait(lock);
+        m_writerWaiting.store(false);
+    }
+
+} // namespace Logi
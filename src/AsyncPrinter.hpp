@@ -0,0 +1,77 @@
+#pragma once
+
+#include "IPrinter.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Logi
+{
+    /// Printer queueing records in a bounded single-producer/single-consumer
+    /// ring buffer and writing them to the underlying printer on a dedicated
+    /// thread, so callers never wait on slow terminal or file I/O.
+    ///
+    /// print() and printBatch() must always be called from the same thread.
+    /// The writer thread sleeps on a condition variable while the queue is
+    /// empty; producers only take the lock to wake it once it is waiting.
+    class AsyncPrinter : public IPrinter
+    {
+    public:
+
+        /// What print() does when the queue is full.
+        enum class OverflowPolicy
+        {
+            Block,  // wait for the writer thread to make room
+            Drop    // discard the record and count it
+        };
+
+        /// \param sink The printer records are written to, only used from the writer thread.
+        /// \param capacity The number of queued records, rounded up to a power of two.
+        /// \param policy What to do when the queue is full.
+        AsyncPrinter(IPrinter& sink, size_t capacity = 1024, OverflowPolicy policy = OverflowPolicy::Block);
+
+        /// Writes the queued records and stops the writer thread.
+        ~AsyncPrinter();
+
+        AsyncPrinter(const AsyncPrinter&) = delete;
+        AsyncPrinter& operator=(const AsyncPrinter&) = delete;
+
+        void print(std::string_view str) override;
+        void printBatch(const PrintBatch& batch) override;
+
+        /// Waits until every queued record has been written to the sink.
+        void flush();
+
+        /// Returns the number of records discarded because the queue was full.
+        size_t dropped() const;
+
+    private:
+
+        bool tryPush(std::string_view str);
+        void run();
+        void waitForRecords(size_t tail);
+
+        IPrinter& m_sink;
+        OverflowPolicy m_policy;
+        std::vector<std::string> m_slots;
+        size_t m_mask{0};
+
+        alignas(64) std::atomic<size_t> m_head{0};  // next slot written by the producer
+        alignas(64) std::atomic<size_t> m_tail{0};  // next slot read by the writer thread
+        alignas(64) std::atomic<bool> m_stop{false};
+        std::atomic<size_t> m_dropped{0};
+        std::atomic<bool> m_writerWaiting{false};
+        std::mutex m_mutex;
+        std::condition_variable m_wakeUp;
+
+        std::string m_text;
+        PrintBatch m_batch;
+        std::thread m_thread;
+    };
+
+} // namespace Logi
@@ -0,0 +1,122 @@
+#include "CommandLine.hpp"
+#include <charconv>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace Logi
+{
+    namespace{
+        template<typename T>
+        T parseNumber(std::string_view option, std::string_view value)
+        {
+            uint64_t number{};
+            auto base = 10;
+            if (value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X'))
+            {
+                value.remove_prefix(2);
+                base = 16;
+            }
+
+            auto result = std::from_chars(value.data(), value.data() + value.size(), number, base);
+            if (result.ec != std::errc{} || result.ptr != value.data() + value.size() || number > std::numeric_limits<T>::max())
+                throw std::invalid_argument("invalid value for " + std::string{option} + ": " + std::string{value});
+
+            return static_cast<T>(number);
+        }
+
+        Endianess parseEndianess(std::string_view value)
+        {
+            if (value == "little") return Endianess::LittleEndian;
+            if (value == "big")    return Endianess::BigEndian;
+            throw std::invalid_argument("invalid endianess: " + std::string{value});
+        }
+
+        EndPacketFlags parseFlags(std::string_view value)
+        {
+            EndPacketFlags flags;
+            while (!value.empty())
+            {
+                auto comma = value.find(',');
+                auto flag = value.substr(0, comma);
+
+                if (flag == "test")        flags.test = true;
+                else if (flag == "verify") flags.verify = true;
+                else if (flag == "reboot") flags.reboot = true;
+                else if (!flag.empty() && flag != "none")
+                    throw std::invalid_argument("invalid flag: " + std::string{flag});
+
+                value.remove_prefix(comma == std::string_view::npos ? value.size() : comma + 1);
+            }
+            return flags;
+        }
+
+        std::string_view parseOutput(std::string_view value)
+        {
+            if (value == "console" || value == "null" || (value.substr(0, 5) == "file:" && value.size() > 5))
+                return value;
+            throw std::invalid_argument("invalid output: " + std::string{value});
+        }
+    }
+
+    CommandLineOptions parseCommandLine(int argc, const char* const argv[])
+    {
+        CommandLineOptions options;
+
+        for (int i = 1; i < argc; i++)
+        {
+            std::string_view arg{argv[i]};
+
+            auto value = [&]() -> std::string_view {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument("missing value for " + std::string{arg});
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help")   options.help = true;
+            else if (arg == "--size")             options.size = parseNumber<uint64_t>(arg, value());
+            else if (arg == "--seed")             options.seed = parseNumber<uint64_t>(arg, value());
+            else if (arg == "--software-id")      options.softwareId = parseNumber<uint8_t>(arg, value());
+            else if (arg == "--endianess")        options.endianess = parseEndianess(value());
+            else if (arg == "--flags")            options.flags = parseFlags(value());
+            else if (arg == "--repeat")           options.repeat = parseNumber<unsigned int>(arg, value());
+            else if (arg == "--segment-size")     options.segmentSize = parseNumber<uint32_t>(arg, value());
+            else if (arg == "--output")           options.output = parseOutput(value());
+            else if (arg == "-q" || arg == "--quiet") options.quiet = true;
+            else if (arg == "--stats")            options.stats = true;
+            else if (arg.substr(0, 1) == "-")
+                throw std::invalid_argument("unknown option: " + std::string{arg});
+            else if (options.inputPath.empty())
+                options.inputPath = arg;
+            else
+                throw std::invalid_argument("unexpected argument: " + std::string{arg});
+        }
+
+        return options;
+    }
+
+    std::string commandLineUsage()
+    {
+        std::ostringstream oss;
+        oss << "Usage: packet_generator [options] [firmware file]\n"
+            << "\n"
+            << "Without arguments the generator runs interactively on random buffers.\n"
+            << "\n"
+            << "Options:\n"
+            << "  --size <bytes>            size of the random buffer (default 1000)\n"
+            << "  --seed <n>                seed of the random buffer\n"
+            << "  --software-id <id>        software id of the packets (default 69)\n"
+            << "  --endianess <little|big>  byte order of the packet fields (default little)\n"
+            << "  --flags <list>            comma separated stop flags: test,verify,reboot\n"
+            << "  --repeat <n>              number of transfers to generate (default 1)\n"
+            << "  --segment-size <bytes>    split the input into transfers of at most this size\n"
+            << "                            (3866506 keeps sequence ids unique per transfer)\n"
+            << "  --output <sink>           console, null or file:<path> (default console)\n"
+            << "  -q, --quiet               do not print the packets\n"
+            << "  --stats                   report packets/s and MB/s\n"
+            << "  -h, --help                show this help\n";
+        return oss.str();
+    }
+
+} // namespace Logi
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "Utils.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Logi
+{
+    /// Options of the non-interactive mode of packet_generator.
+    struct CommandLineOptions
+    {
+        std::string inputPath;            // firmware file, a random buffer is used when empty
+        uint64_t size{1000};              // size of the random buffer
+        std::optional<uint64_t> seed;     // seed of the random buffer, random when not set
+        uint8_t softwareId{69};
+        Endianess endianess{Endianess::LittleEndian};
+        EndPacketFlags flags;
+        unsigned int repeat{1};           // number of transfers generated
+        std::optional<uint64_t> segmentSize;  // split inputs into transfers of at most this size
+        std::string output{"console"};    // "console", "null" or "file:<path>"
+        bool quiet{false};                // do not print the packets
+        bool stats{false};                // report packets/s and MB/s
+        bool help{false};
+    };
+
+    /// Parses the command line arguments.
+    ///
+    /// \param argc The number of arguments, including the program name.
+    /// \param argv The arguments.
+    /// \return The parsed options.
+    /// \throw std::invalid_argument on unknown options or invalid values.
+    CommandLineOptions parseCommandLine(int argc, const char* const argv[]);
+
+    /// Returns the description of the command line options.
+    std::string commandLineUsage();
+
+} // namespace Logi
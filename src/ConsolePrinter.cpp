@@ -8,4 +8,9 @@ namespace Logi
         std::cout << str << "\n";
     }
 
+    void ConsolePrinter::printBatch(const PrintBatch& batch)
+    {
+        std::cout.write(batch.text.data(), batch.text.size());
+    }
+
 } // namespace Logi
\ No newline at end of file
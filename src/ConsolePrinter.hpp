@@ -13,6 +13,7 @@ namespace Logi
         ~ConsolePrinter() = default;
 
         void print(std::string_view str) override;
+        void printBatch(const PrintBatch& batch) override;
     };
 
 } // namespace Logi
\ No newline at end of file
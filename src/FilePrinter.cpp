@@ -0,0 +1,89 @@
+#include "FilePrinter.hpp"
+#include "SystemError.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace Logi
+{
+    FilePrinter::FilePrinter(const std::string& path, size_t bufferSize)
+        : m_fd{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)}
+        , m_ownsFd{true}
+        , m_buffer(bufferSize)
+    {
+        if (m_fd < 0)
+            throwSystemError("cannot open " + path);
+    }
+
+    FilePrinter::FilePrinter(int fd, size_t bufferSize)
+        : m_fd{fd}
+        , m_buffer(bufferSize)
+    {}
+
+    FilePrinter::~FilePrinter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (const std::system_error&)
+        {
+            // nothing sensible left to do with the remaining bytes
+        }
+
+        if (m_ownsFd)
+            ::close(m_fd);
+    }
+
+    void FilePrinter::print(std::string_view str)
+    {
+        append(str);
+        append("\n");
+    }
+
+    void FilePrinter::printBatch(const PrintBatch& batch)
+    {
+        append(batch.text);
+    }
+
+    void FilePrinter::flush()
+    {
+        writeAll(m_buffer.data(), m_size);
+        m_size = 0;
+    }
+
+    void FilePrinter::append(std::string_view str)
+    {
+        if (m_size + str.size() > m_buffer.size())
+        {
+            flush();
+            if (str.size() > m_buffer.size())
+            {
+                writeAll(str.data(), str.size());  // too large to be buffered
+                return;
+            }
+        }
+
+        std::memcpy(m_buffer.data() + m_size, str.data(), str.size());
+        m_size += str.size();
+    }
+
+    void FilePrinter::writeAll(const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            auto written = ::write(m_fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throwSystemError("cannot write packets dump");
+            }
+            data += written;
+            size -= written;
+        }
+    }
+
+} // namespace Logi
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "IPrinter.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Logi
+{
+    /// Printer writing to a file descriptor through a large user-space buffer,
+    /// with one write() per flush instead of one stream operation per record.
+    class FilePrinter : public IPrinter
+    {
+    public:
+
+        static constexpr size_t s_defaultBufferSize = 1024 * 1024;
+
+        /// Creates or truncates the file at path.
+        ///
+        /// \param path The path of the file to be written.
+        /// \param bufferSize The number of bytes buffered before writing.
+        explicit FilePrinter(const std::string& path, size_t bufferSize = s_defaultBufferSize);
+
+        /// Writes to an already open file descriptor, which is left open.
+        ///
+        /// \param fd The file descriptor to be written.
+        /// \param bufferSize The number of bytes buffered before writing.
+        explicit FilePrinter(int fd, size_t bufferSize = s_defaultBufferSize);
+
+        /// Flushes the buffer and closes the file if it was opened by the printer.
+        ~FilePrinter();
+
+        FilePrinter(const FilePrinter&) = delete;
+        FilePrinter& operator=(const FilePrinter&) = delete;
+
+        void print(std::string_view str) override;
+        void printBatch(const PrintBatch& batch) override;
+
+        /// Writes the buffered bytes to the file.
+        void flush();
+
+    private:
+
+        void append(std::string_view str);
+        void writeAll(const char* data, size_t size);
+
+        int m_fd{-1};
+        bool m_ownsFd{false};
+        std::vector<char> m_buffer;
+        size_t m_size{0};
+    };
+
+} // namespace Logi
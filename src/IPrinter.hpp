@@ -1,9 +1,17 @@
 #pragma once
 
 #include <string_view>
+#include <vector>
 
 namespace Logi
 {
+    /// Records printed together, laid out one after the other in text, each
+    /// followed by a newline.
+    struct PrintBatch
+    {
+        std::string_view text;
+        std::vector<std::string_view> records;
+    };
 
     class IPrinter
     {
@@ -12,6 +20,20 @@ namespace Logi
         virtual ~IPrinter() {};
 
         virtual void print(std::string_view str) = 0;
+
+        /// Prints several records with a single call.
+        ///
+        /// The default implementation prints the records one by one, printers
+        /// able to write the whole text at once should override it.
+        ///
+        /// \param batch The records to be printed.
+        virtual void printBatch(const PrintBatch& batch)
+        {
+            for (auto record : batch.records)
+            {
+                print(record);
+            }
+        }
     };
 
 } // namespace Logi
\ No newline at end of file
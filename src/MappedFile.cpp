@@ -0,0 +1,140 @@
+#include "MappedFile.hpp"
+#include "SystemError.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace Logi
+{
+    MappedFile MappedFile::create(const std::string& path, size_t size)
+    {
+        FileDescriptor fd{::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+        if (fd.get() < 0)
+            throwSystemError("cannot open " + path);
+
+        if (::ftruncate(fd.get(), static_cast<off_t>(size)) < 0)
+            throwSystemError("cannot resize " + path);
+
+        if (size == 0)
+            return MappedFile{nullptr, 0};
+
+        auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+        if (address == MAP_FAILED)
+            throwSystemError("cannot map " + path);
+
+        return MappedFile{address, size};
+    }
+
+    ReadOnlyMappedFile ReadOnlyMappedFile::open(const std::string& path)
+    {
+        FileDescriptor fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd.get() < 0)
+            throwSystemError("cannot open " + path);
+
+        struct stat status;
+        if (::fstat(fd.get(), &status) < 0)
+            throwSystemError("cannot read size of " + path);
+
+        auto size = static_cast<size_t>(status.st_size);
+        if (size == 0)
+            return ReadOnlyMappedFile{nullptr, 0};
+
+        auto address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+        if (address == MAP_FAILED)
+            throwSystemError("cannot map " + path);
+
+        ::madvise(address, size, MADV_SEQUENTIAL);  // packets are generated front to back
+
+        return ReadOnlyMappedFile{address, size};
+    }
+
+    FileMapping::FileMapping(void* address, size_t size)
+        : m_address{address}
+        , m_size{size}
+    {}
+
+    FileMapping::FileMapping(FileMapping&& other) noexcept
+        : m_address{std::exchange(other.m_address, nullptr)}
+        , m_size{std::exchange(other.m_size, 0)}
+    {}
+
+    FileMapping& FileMapping::operator=(FileMapping&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            m_address = std::exchange(other.m_address, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    FileMapping::~FileMapping()
+    {
+        unmap();
+    }
+
+    std::byte* MappedFile::data()
+    {
+        return static_cast<std::byte*>(m_address);
+    }
+
+    const std::byte* MappedFile::data() const
+    {
+        return static_cast<const std::byte*>(m_address);
+    }
+
+    const std::byte* ReadOnlyMappedFile::data() const
+    {
+        return static_cast<const std::byte*>(m_address);
+    }
+
+    size_t FileMapping::size() const
+    {
+        return m_size;
+    }
+
+    void FileMapping::unmap()
+    {
+        if (m_address)
+            ::munmap(m_address, m_size);
+        m_address = nullptr;
+        m_size = 0;
+    }
+
+    size_t serializeToMappedFile(PacketGenerator& generator, const std::string& path, const std::byte* buffer, size_t size, const EndPacketFlags& flags)
+    {
+        // Checked before any file is touched
+        if (size > PacketGenerator::s_maxTransferBytes)
+            throw std::length_error("transfer larger than 4 GiB, it has to be segmented");
+
+        // Written next to the destination and renamed once complete, so that a
+        // failure leaves an existing file untouched
+        auto temporaryPath = path + ".tmp" + std::to_string(::getpid());
+        try
+        {
+            size_t written = 0;
+            {
+                auto file = MappedFile::create(temporaryPath, PacketGenerator::serializedSize(size));
+                written = generator.serialize(buffer, size, flags, file.data(), file.size());
+            }
+
+            if (::rename(temporaryPath.c_str(), path.c_str()) < 0)
+                throwSystemError("cannot rename " + temporaryPath + " to " + path);
+            return written;
+        }
+        catch (...)
+        {
+            ::unlink(temporaryPath.c_str());
+            throw;
+        }
+    }
+
+} // namespace Logi
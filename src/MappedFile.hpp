@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "PacketGenerator.hpp"
+#include <cstddef>
+#include <string>
+
+namespace Logi
+{
+    /// Memory mapping of a whole file, unmapped on destruction.
+    class FileMapping
+    {
+    public:
+
+        FileMapping(FileMapping&& other) noexcept;
+        FileMapping& operator=(FileMapping&& other) noexcept;
+        ~FileMapping();
+
+        FileMapping(const FileMapping&) = delete;
+        FileMapping& operator=(const FileMapping&) = delete;
+
+        size_t size() const;
+
+    protected:
+
+        FileMapping(void* address, size_t size);
+        void unmap();
+
+        void* m_address{nullptr};
+        size_t m_size{0};
+    };
+
+    /// Writable mapping of a file.
+    class MappedFile : public FileMapping
+    {
+    public:
+
+        /// Creates or truncates the file at path, resizes it and maps it for writing.
+        ///
+        /// \param path The path of the file.
+        /// \param size The size of the file.
+        /// \return The mapping.
+        static MappedFile create(const std::string& path, size_t size);
+
+        std::byte* data();
+        const std::byte* data() const;
+
+    private:
+
+        using FileMapping::FileMapping;
+    };
+
+    /// Read-only mapping of a file, whose bytes cannot be written through it.
+    class ReadOnlyMappedFile : public FileMapping
+    {
+    public:
+
+        /// Maps the existing file at path read-only.
+        ///
+        /// \param path The path of the file.
+        /// \return The mapping.
+        static ReadOnlyMappedFile open(const std::string& path);
+
+        const std::byte* data() const;
+
+    private:
+
+        using FileMapping::FileMapping;
+    };
+
+    /// Serializes a transfer straight into a memory-mapped file sized from
+    /// PacketGenerator::serializedSize, without an intermediate Packets vector.
+    ///
+    /// The transfer is written to a temporary file renamed to path once
+    /// complete, an existing file being left as it was if anything fails.
+    ///
+    /// \param generator The generator encoding the packets.
+    /// \param path The path of the output file, created or truncated.
+    /// \param buffer The buffer containing data to be encoded.
+    /// \param size The size of the buffer.
+    /// \return The size of the written file.
+    size_t serializeToMappedFile(PacketGenerator& generator, const std::string& path, const std::byte* buffer, size_t size, const EndPacketFlags& flags);
+
+} // namespace Logi
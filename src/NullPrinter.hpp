@@ -0,0 +1,17 @@
+#pragma once
+
+#include "IPrinter.hpp"
+
+namespace Logi
+{
+
+    /// Printer discarding everything, used to measure generation alone.
+    class NullPrinter : public IPrinter
+    {
+    public:
+
+        void print(std::string_view) override {}
+        void printBatch(const PrintBatch&) override {}
+    };
+
+} // namespace Logi
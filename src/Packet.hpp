@@ -3,10 +3,13 @@
 #include <array>
 #include <bitset>
 #include <cstddef>
+#include <type_traits>
 #include <vector>
 
 namespace Logi
 {
+    constexpr size_t maxPayloadSize = 59;
+
     enum class PacketType
     {
         StartDataTransfer = 1,
@@ -42,7 +45,19 @@ namespace Logi
     {
         PacketHeader header;
         uint8_t payloadSize{};
-        std::vector<std::byte> data;
+        std::array<std::byte, maxPayloadSize> data{};  // only the first payloadSize bytes are valid
+    };
+
+    static_assert(sizeof(DataPacket) == 64, "DataPacket should fit in a cache line");
+    static_assert(std::is_trivially_copyable_v<DataPacket>, "DataPacket should be trivially copyable");
+
+    /// Data packet referencing its payload in the caller's buffer.
+    /// It is only valid as long as that buffer is alive.
+    struct DataPacketView
+    {
+        PacketHeader header;
+        uint8_t payloadSize{};
+        const std::byte* data{};
     };
 
     struct StopDataTransferPacket
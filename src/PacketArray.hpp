@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Packet.hpp"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace Logi
+{
+    using PacketVariant = std::variant<StartDataTransferPacket, DataPacket, StopDataTransferPacket>;
+
+    static_assert(std::is_trivially_destructible_v<PacketVariant>, "packets are released without destroying them");
+
+    /// Fixed-size array of packets whose storage is left uninitialized until
+    /// each packet is constructed in place.
+    ///
+    /// Unlike a std::vector sized up front, nothing is written to the storage
+    /// before the packets, so disjoint index ranges can be filled by several
+    /// threads with a single pass over the memory. Every packet has to be
+    /// constructed before it is read.
+    class PacketArray
+    {
+    public:
+
+        using value_type = PacketVariant;
+        using iterator = PacketVariant*;
+        using const_iterator = const PacketVariant*;
+
+        explicit PacketArray(size_t size)
+            : m_packets{std::allocator<PacketVariant>{}.allocate(size)}
+            , m_size{size}
+        {}
+
+        PacketArray(PacketArray&& other) noexcept
+            : m_packets{std::exchange(other.m_packets, nullptr)}
+            , m_size{std::exchange(other.m_size, 0)}
+        {}
+
+        PacketArray& operator=(PacketArray&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                m_packets = std::exchange(other.m_packets, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            return *this;
+        }
+
+        ~PacketArray()
+        {
+            release();
+        }
+
+        PacketArray(const PacketArray&) = delete;
+        PacketArray& operator=(const PacketArray&) = delete;
+
+        /// Constructs the packet at index, which must not have been constructed yet.
+        template<typename Packet>
+        void construct(size_t index, const Packet& packet)
+        {
+            ::new (static_cast<void*>(m_packets + index)) PacketVariant(packet);
+        }
+
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        PacketVariant& operator[](size_t index) { return m_packets[index]; }
+        const PacketVariant& operator[](size_t index) const { return m_packets[index]; }
+
+        const PacketVariant& at(size_t index) const
+        {
+            if (index >= m_size)
+                throw std::out_of_range("packet index out of range");
+            return m_packets[index];
+        }
+
+        const PacketVariant& front() const { return m_packets[0]; }
+        const PacketVariant& back() const { return m_packets[m_size - 1]; }
+
+        iterator begin() { return m_packets; }
+        iterator end() { return m_packets + m_size; }
+        const_iterator begin() const { return m_packets; }
+        const_iterator end() const { return m_packets + m_size; }
+
+    private:
+
+        void release()
+        {
+            if (m_packets)
+                std::allocator<PacketVariant>{}.deallocate(m_packets, m_size);
+            m_packets = nullptr;
+            m_size = 0;
+        }
+
+        PacketVariant* m_packets{nullptr};
+        size_t m_size{0};
+    };
+
+} // namespace Logi
@@ -0,0 +1,146 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "PacketCoroutine.hpp requires C++20 coroutine support"
+#endif
+
+#include "PacketGenerator.hpp"
+#include "PacketStream.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace Logi
+{
+    /// Minimal lazy generator for producers written with co_yield.
+    ///
+    /// The producer only runs when the consumer asks for the next value, so a
+    /// slow consumer naturally holds the producer back.
+    template<typename T>
+    class Generator
+    {
+    public:
+
+        struct promise_type
+        {
+            const T* m_value{nullptr};
+            std::exception_ptr m_exception;
+
+            Generator get_return_object() { return Generator{Handle::from_promise(*this)}; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { m_exception = std::current_exception(); }
+
+            std::suspend_always yield_value(const T& value) noexcept
+            {
+                m_value = std::addressof(value);
+                return {};
+            }
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        class Iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            Iterator() = default;
+            explicit Iterator(Generator* generator) : m_generator{generator} {}
+
+            reference operator*() const { return m_generator->value(); }
+            pointer operator->() const { return std::addressof(m_generator->value()); }
+
+            Iterator& operator++()
+            {
+                if (!m_generator->next())
+                    m_generator = nullptr;
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(const Iterator& other) const { return m_generator == other.m_generator; }
+            bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+        private:
+            Generator* m_generator{nullptr};
+        };
+
+        Generator(Generator&& other) noexcept : m_handle{std::exchange(other.m_handle, nullptr)} {}
+
+        Generator& operator=(Generator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+            return *this;
+        }
+
+        Generator(const Generator&) = delete;
+        Generator& operator=(const Generator&) = delete;
+
+        ~Generator()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+        /// Resumes the producer until it yields the next value.
+        ///
+        /// \return False once the producer has finished.
+        bool next()
+        {
+            if (!m_handle || m_handle.done())
+                return false;
+
+            m_handle.resume();
+            if (m_handle.promise().m_exception)
+                std::rethrow_exception(std::exchange(m_handle.promise().m_exception, nullptr));
+
+            return !m_handle.done();
+        }
+
+        /// Returns the value last yielded by the producer.
+        const T& value() const { return *m_handle.promise().m_value; }
+
+        Iterator begin() { return next() ? Iterator{this} : Iterator{}; }
+        Iterator end() { return {}; }
+
+    private:
+
+        explicit Generator(Handle handle) : m_handle{handle} {}
+
+        Handle m_handle;
+    };
+
+    /// Yields the packets of a transfer, suspending after each one.
+    ///
+    /// Nothing is generated until the first packet is requested. The generator
+    /// and the input buffer must outlive the returned coroutine.
+    ///
+    /// \param generator The generator stamping the packet headers.
+    /// \param buffer The buffer containing data to be encoded.
+    /// \param size The size of the buffer.
+    /// \return The coroutine producing the packets.
+    inline Generator<PacketVariant> generatePackets(PacketGenerator& generator, const std::byte* buffer, size_t size, EndPacketFlags flags)
+    {
+        PacketStream stream{generator, buffer, size, flags};
+        while (auto packet = stream.next())
+        {
+            co_yield *packet;
+        }
+    }
+
+} // namespace Logi
@@ -0,0 +1,205 @@
+#include "PacketDecoder.hpp"
+#include "PacketEncoder.hpp"
+#include "WireFormat.hpp"
+#include <cstring>
+#include <string>
+
+namespace Logi
+{
+    namespace{
+        const char* packetTypeName(PacketType type)
+        {
+            switch (type)
+            {
+            case PacketType::StartDataTransfer: return "start";
+            case PacketType::Data:              return "data";
+            case PacketType::StopDataTransfer:  return "stop";
+            }
+            return "unknown";
+        }
+
+        bool isPacketType(uint8_t type)
+        {
+            return type >= static_cast<uint8_t>(PacketType::StartDataTransfer) &&
+                   type <= static_cast<uint8_t>(PacketType::StopDataTransfer);
+        }
+    }
+
+    PacketDecoder::PacketDecoder(uint8_t softwareId, Endianess endianess, size_t maxTransferBytes)
+        : m_softwareId{softwareId}
+        , m_swapByteOrder{swapByteOrder(endianess)}
+        , m_maxTransferBytes{maxTransferBytes}
+    {}
+
+    size_t PacketDecoder::decode(const std::byte* data, size_t size)
+    {
+        return dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return decodeImpl<decltype(byteOrder)::value>(data, size);
+        });
+    }
+
+    void PacketDecoder::decode(const PacketVariant& packet)
+    {
+        dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            constexpr auto ByteOrder = decltype(byteOrder)::value;
+            if (auto start = std::get_if<StartDataTransferPacket>(&packet))
+                decodePacket<ByteOrder>(*start);
+            else if (auto dataPacket = std::get_if<DataPacket>(&packet))
+                decodePacket<ByteOrder>(dataPacket->header, dataPacket->payloadSize, dataPacket->data.data());
+            else
+                decodePacket<ByteOrder>(std::get<StopDataTransferPacket>(packet));
+        });
+    }
+
+    void PacketDecoder::decode(const Packets& packets)
+    {
+        for (const auto& packet : packets)
+        {
+            decode(packet);
+        }
+    }
+
+    bool PacketDecoder::done() const
+    {
+        return m_state == State::Done;
+    }
+
+    const std::vector<std::byte>& PacketDecoder::payload() const
+    {
+        return m_payload;
+    }
+
+    EndPacketFlags PacketDecoder::flags() const
+    {
+        EndPacketFlags flags;
+        flags.reboot = readBit(m_flags, 0);
+        flags.verify = readBit(m_flags, 1);
+        flags.test   = readBit(m_flags, 2);
+        return flags;
+    }
+
+    template<Endianess ByteOrder>
+    size_t PacketDecoder::decodeImpl(const std::byte* data, size_t size)
+    {
+        size_t offset = 0;
+        while (size - offset >= headerWireSize)
+        {
+            auto in = data + offset;
+            auto header = readHeader(in);
+            if (!isPacketType(header.packetType))
+                throw DecodeError("unknown packet type " + std::to_string(header.packetType));
+
+            switch (static_cast<PacketType>(header.packetType))
+            {
+            case PacketType::StartDataTransfer:
+            {
+                if (size - offset < startPacketWireSize)
+                    return offset;
+
+                StartDataTransferPacket packet;
+                packet.header = header;
+                packet.totalPayloadSize_0 = static_cast<uint8_t>(in[headerWireSize + 0]);
+                packet.totalPayloadSize_1 = static_cast<uint8_t>(in[headerWireSize + 1]);
+                packet.totalPayloadSize_2 = static_cast<uint8_t>(in[headerWireSize + 2]);
+                packet.totalPayloadSize_3 = static_cast<uint8_t>(in[headerWireSize + 3]);
+                decodePacket<ByteOrder>(packet);
+                offset += startPacketWireSize;
+                break;
+            }
+
+            case PacketType::Data:
+            {
+                if (size - offset < dataPacketWireOverhead)
+                    return offset;
+
+                auto payloadSize = static_cast<uint8_t>(in[headerWireSize]);
+                if (size - offset < dataPacketWireOverhead + payloadSize)
+                    return offset;
+
+                decodePacket<ByteOrder>(header, payloadSize, in + dataPacketWireOverhead);
+                offset += dataPacketWireOverhead + payloadSize;
+                break;
+            }
+
+            case PacketType::StopDataTransfer:
+            {
+                if (size - offset < stopPacketWireSize)
+                    return offset;
+
+                StopDataTransferPacket packet;
+                packet.header = header;
+                packet.flags = static_cast<uint8_t>(in[headerWireSize]);
+                decodePacket<ByteOrder>(packet);
+                return offset + stopPacketWireSize;
+            }
+            }
+        }
+        return offset;
+    }
+
+    template<Endianess ByteOrder>
+    void PacketDecoder::checkHeader(const PacketHeader& header, PacketType type)
+    {
+        if (header.softwareId != m_softwareId)
+            throw DecodeError("unexpected software id " + std::to_string(header.softwareId) + ", expected " + std::to_string(m_softwareId));
+
+        auto expected = PacketType::StartDataTransfer;
+        if (m_state == State::Data)
+            expected = PacketType::Data;
+        else if (m_state == State::Stop)
+            expected = PacketType::StopDataTransfer;
+
+        if (type != expected)
+            throw DecodeError(std::string{"unexpected "} + packetTypeName(type) + " packet, expected a " + packetTypeName(expected) + " packet");
+
+        auto sequenceId = PacketEncoder<ByteOrder>::readSequenceId(header);
+        if (m_hasSequenceId && sequenceId != m_nextSequenceId)
+            throw DecodeError("unexpected sequence id " + std::to_string(sequenceId) + ", expected " + std::to_string(m_nextSequenceId));
+
+        m_hasSequenceId = true;
+        m_nextSequenceId = static_cast<uint16_t>(sequenceId + 1);  // wraps around after 0xFFFF
+    }
+
+    template<Endianess ByteOrder>
+    void PacketDecoder::decodePacket(const StartDataTransferPacket& packet)
+    {
+        if (m_state == State::Done)
+            m_state = State::Start;
+        checkHeader<ByteOrder>(packet.header, PacketType::StartDataTransfer);
+
+        auto totalPayloadSize = PacketEncoder<ByteOrder>::readTotalPayloadSize(packet);
+        if (totalPayloadSize > m_maxTransferBytes)
+            throw DecodeError("total payload size " + std::to_string(totalPayloadSize) + " exceeds the maximum of " + std::to_string(m_maxTransferBytes) + " bytes");
+
+        m_payload.resize(totalPayloadSize);
+        m_received = 0;
+        m_flags = 0;
+        m_state = m_payload.empty() ? State::Stop : State::Data;
+    }
+
+    template<Endianess ByteOrder>
+    void PacketDecoder::decodePacket(const PacketHeader& header, uint8_t payloadSize, const std::byte* payload)
+    {
+        checkHeader<ByteOrder>(header, PacketType::Data);
+
+        if (payloadSize == 0 || payloadSize > maxPayloadSize)
+            throw DecodeError("invalid data packet payload size " + std::to_string(payloadSize));
+        if (payloadSize > m_payload.size() - m_received)
+            throw DecodeError("data packets exceed the total payload size of " + std::to_string(m_payload.size()) + " bytes");
+
+        std::memcpy(m_payload.data() + m_received, payload, payloadSize);
+        m_received += payloadSize;
+        if (m_received == m_payload.size())
+            m_state = State::Stop;
+    }
+
+    template<Endianess ByteOrder>
+    void PacketDecoder::decodePacket(const StopDataTransferPacket& packet)
+    {
+        checkHeader<ByteOrder>(packet.header, PacketType::StopDataTransfer);
+
+        m_flags = packet.flags;
+        m_state = State::Done;
+    }
+
+} // namespace Logi
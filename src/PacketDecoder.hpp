@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "PacketGenerator.hpp"
+#include "Utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Logi
+{
+    /// Thrown when the packets do not form a valid transfer.
+    class DecodeError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /// Rebuilds the payload of a transfer from its packets, the way the device does.
+    ///
+    /// Every packet is checked for the expected software id, packet type and
+    /// sequence id, the first packet decoded setting the starting sequence id.
+    /// The payload buffer is allocated once from the total payload size of the
+    /// start packet and the data packets are copied straight into it. Start
+    /// packets declaring more than the maximum transfer size are rejected
+    /// before anything is allocated.
+    ///
+    /// A new start packet after a completed transfer begins the next one, the
+    /// sequence ids continuing across transfers.
+    class PacketDecoder
+    {
+    public:
+
+        /// Default largest total payload size accepted from a start packet.
+        static constexpr size_t s_defaultMaxTransferBytes = 256 * 1024 * 1024;
+
+        /// \param softwareId The software id of the packets.
+        /// \param endianess The byte order of the packet fields.
+        /// \param maxTransferBytes The largest total payload size accepted from a start packet.
+        explicit PacketDecoder(uint8_t softwareId, Endianess endianess = Endianess::LittleEndian,
+            size_t maxTransferBytes = s_defaultMaxTransferBytes);
+
+        /// Decodes serialized packets.
+        ///
+        /// Decoding stops after a stop packet, so that the transfer can be
+        /// collected before the next one starts, or before an incomplete packet
+        /// at the end of the input.
+        ///
+        /// \param data The serialized packets.
+        /// \param size The size of the data.
+        /// \return The number of bytes consumed.
+        size_t decode(const std::byte* data, size_t size);
+
+        /// Decodes a single packet.
+        ///
+        /// \param packet The packet to be decoded.
+        void decode(const PacketVariant& packet);
+
+        /// Decodes the packets in order.
+        ///
+        /// \param packets The packets to be decoded.
+        void decode(const Packets& packets);
+
+        /// Returns whether the stop packet of the current transfer has been decoded.
+        bool done() const;
+
+        /// Returns the payload of the current transfer, complete once done.
+        const std::vector<std::byte>& payload() const;
+
+        /// Returns the flags of the stop packet of the last completed transfer.
+        EndPacketFlags flags() const;
+
+    private:
+
+        enum class State
+        {
+            Start,
+            Data,
+            Stop,
+            Done
+        };
+
+        template<Endianess ByteOrder> size_t decodeImpl(const std::byte* data, size_t size);
+        template<Endianess ByteOrder> void checkHeader(const PacketHeader& header, PacketType type);
+        template<Endianess ByteOrder> void decodePacket(const StartDataTransferPacket& packet);
+        template<Endianess ByteOrder> void decodePacket(const PacketHeader& header, uint8_t payloadSize, const std::byte* payload);
+        template<Endianess ByteOrder> void decodePacket(const StopDataTransferPacket& packet);
+
+        uint8_t m_softwareId{0};
+        bool m_swapByteOrder{false};
+        bool m_hasSequenceId{false};
+        uint16_t m_nextSequenceId{0};
+        size_t m_maxTransferBytes{0};
+        State m_state{State::Start};
+        size_t m_received{0};
+        uint8_t m_flags{0};
+        std::vector<std::byte> m_payload;
+    };
+
+} // namespace Logi
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "Utils.hpp"
+#include <cstdint>
+#include <type_traits>
+
+namespace Logi
+{
+    /// Reads and writes the multi-byte packet fields in a byte order resolved at
+    /// compile time, so header stamping compiles down to plain stores.
+    ///
+    /// BigEndian stores the most significant byte first (the swapped order),
+    /// LittleEndian the least significant byte first.
+    template<Endianess ByteOrder>
+    struct PacketEncoder
+    {
+        static void writeSequenceId(PacketHeader& header, uint16_t sequenceId)
+        {
+            if constexpr (ByteOrder == Endianess::BigEndian)
+            {
+                header.sequenceId_0 = sequenceId >> 8;
+                header.sequenceId_1 = sequenceId & 0xFF;
+            }
+            else
+            {
+                header.sequenceId_0 = sequenceId & 0xFF;
+                header.sequenceId_1 = sequenceId >> 8;
+            }
+        }
+
+        static void writeTotalPayloadSize(StartDataTransferPacket& packet, uint32_t totalPayloadSize)
+        {
+            if constexpr (ByteOrder == Endianess::BigEndian)
+            {
+                packet.totalPayloadSize_0 = totalPayloadSize >> 24;
+                packet.totalPayloadSize_1 = totalPayloadSize >> 16;
+                packet.totalPayloadSize_2 = totalPayloadSize >> 8;
+                packet.totalPayloadSize_3 = totalPayloadSize & 0xFF;
+            }
+            else
+            {
+                packet.totalPayloadSize_0 = totalPayloadSize & 0xFF;
+                packet.totalPayloadSize_1 = totalPayloadSize >> 8;
+                packet.totalPayloadSize_2 = totalPayloadSize >> 16;
+                packet.totalPayloadSize_3 = totalPayloadSize >> 24;
+            }
+        }
+
+        static uint16_t readSequenceId(const PacketHeader& header)
+        {
+            if constexpr (ByteOrder == Endianess::BigEndian)
+                return (header.sequenceId_0 << 8) | header.sequenceId_1;
+            else
+                return header.sequenceId_0 | (header.sequenceId_1 << 8);
+        }
+
+        static uint32_t readTotalPayloadSize(const StartDataTransferPacket& packet)
+        {
+            if constexpr (ByteOrder == Endianess::BigEndian)
+                return (uint32_t{packet.totalPayloadSize_0} << 24) | (uint32_t{packet.totalPayloadSize_1} << 16) |
+                       (uint32_t{packet.totalPayloadSize_2} << 8)  |  uint32_t{packet.totalPayloadSize_3};
+            else
+                return  uint32_t{packet.totalPayloadSize_0}        | (uint32_t{packet.totalPayloadSize_1} << 8) |
+                       (uint32_t{packet.totalPayloadSize_2} << 16) | (uint32_t{packet.totalPayloadSize_3} << 24);
+        }
+    };
+
+    /// Returns whether fields of the requested byte order are encoded in the
+    /// swapped (BigEndian) order on this host.
+    inline bool swapByteOrder(Endianess endianess)
+    {
+        return static_cast<bool>(checkHostEndianess()) || static_cast<bool>(endianess);
+    }
+
+    /// Calls the function with the byte order selected at runtime as a
+    /// compile-time constant (std::integral_constant<Endianess, ...>).
+    template<typename Function>
+    decltype(auto) dispatchByteOrder(bool swapByteOrder, Function&& function)
+    {
+        if (swapByteOrder)
+            return function(std::integral_constant<Endianess, Endianess::BigEndian>{});
+        return function(std::integral_constant<Endianess, Endianess::LittleEndian>{});
+    }
+
+} // namespace Logi
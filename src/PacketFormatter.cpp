@@ -0,0 +1,149 @@
+#include "PacketFormatter.hpp"
+#include "PacketEncoder.hpp"
+#include "Utils.hpp"
+#include <charconv>
+
+namespace Logi
+{
+    namespace{
+        constexpr char s_hexDigits[] = "0123456789ABCDEF";
+
+        std::string_view packetTypeName(uint8_t type)
+        {
+            switch (static_cast<PacketType>(type))
+            {
+            case PacketType::Data:              return "Data";
+            case PacketType::StartDataTransfer: return "StartDataTransfer";
+            case PacketType::StopDataTransfer:  return "StopDataTransfer";
+            }
+            return "";
+        }
+    }
+
+    PacketFormatter::PacketFormatter(bool swapByteOrder)
+        : m_swapByteOrder{swapByteOrder}
+    {}
+
+    void PacketFormatter::format(const StartDataTransferPacket& packet)
+    {
+        auto totalSize = dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return PacketEncoder<decltype(byteOrder)::value>::readTotalPayloadSize(packet);
+        });
+
+        appendHeader(packet.header);
+        append("total payload size: ");
+        appendDecimal(totalSize);
+        append("\n");
+        endRecord();
+    }
+
+    void PacketFormatter::format(const DataPacket& packet)
+    {
+        appendHeader(packet.header);
+        append("payload size: ");
+        appendDecimal(packet.payloadSize);
+        append("\n");
+        endRecord();
+    }
+
+    void PacketFormatter::format(const DataPacketView& packet)
+    {
+        appendHeader(packet.header);
+        append("payload size: ");
+        appendDecimal(packet.payloadSize);
+        append("\n");
+        endRecord();
+    }
+
+    void PacketFormatter::format(const StopDataTransferPacket& packet)
+    {
+        appendHeader(packet.header);
+        append("test: ");
+        appendBool(readBit(packet.flags, 2));
+        append("verify: ");
+        appendBool(readBit(packet.flags, 1));
+        append("reboot: ");
+        appendBool(readBit(packet.flags, 0));
+        endRecord();
+    }
+
+    size_t PacketFormatter::size() const
+    {
+        return m_buffer.size();
+    }
+
+    bool PacketFormatter::empty() const
+    {
+        return m_buffer.empty();
+    }
+
+    const PrintBatch& PacketFormatter::batch()
+    {
+        m_batch.text = m_buffer;
+        m_batch.records.clear();
+        for (size_t i = 0; i < m_recordOffsets.size(); i++)
+        {
+            // Each record ends before the newline following it
+            auto end = (i + 1 < m_recordOffsets.size()) ? m_recordOffsets[i + 1] : m_buffer.size();
+            m_batch.records.emplace_back(m_buffer.data() + m_recordOffsets[i], end - 1 - m_recordOffsets[i]);
+        }
+        return m_batch;
+    }
+
+    void PacketFormatter::clear()
+    {
+        m_buffer.clear();
+        m_recordOffsets.clear();
+    }
+
+    void PacketFormatter::appendHeader(const PacketHeader& header)
+    {
+        auto sequenceId = dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return PacketEncoder<decltype(byteOrder)::value>::readSequenceId(header);
+        });
+
+        m_recordOffsets.push_back(m_buffer.size());
+
+        append("software id: 0x");
+        appendHex(header.softwareId, 2);
+        append("\nsequence id: 0x");
+        appendHex(sequenceId, 4);
+        append("\npacket type: ");
+        append(packetTypeName(header.packetType));
+        append("\n");
+    }
+
+    void PacketFormatter::endRecord()
+    {
+        append("\n");
+    }
+
+    void PacketFormatter::appendHex(uint32_t value, int digits)
+    {
+        auto offset = m_buffer.size();
+        m_buffer.resize(offset + digits);
+        for (int i = digits - 1; i >= 0; i--)
+        {
+            m_buffer[offset + i] = s_hexDigits[value & 0xF];
+            value >>= 4;
+        }
+    }
+
+    void PacketFormatter::appendDecimal(uint32_t value)
+    {
+        char digits[10];
+        auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+        m_buffer.append(digits, result.ptr);
+    }
+
+    void PacketFormatter::appendBool(bool value)
+    {
+        append(value ? "true\n" : "false\n");
+    }
+
+    void PacketFormatter::append(std::string_view str)
+    {
+        m_buffer.append(str);
+    }
+
+} // namespace Logi
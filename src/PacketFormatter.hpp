@@ -0,0 +1,52 @@
+#pragma once
+
+#include "IPrinter.hpp"
+#include "Packet.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Logi
+{
+    /// Formats packets as text into one growing buffer without iostreams.
+    ///
+    /// Each packet is one record of the buffer, followed by a newline, so that
+    /// the buffer is the text a printer writes. The buffer keeps its capacity
+    /// across clear() calls so it can be reused batch after batch.
+    class PacketFormatter
+    {
+    public:
+
+        explicit PacketFormatter(bool swapByteOrder);
+
+        void format(const StartDataTransferPacket& packet);
+        void format(const DataPacket& packet);
+        void format(const DataPacketView& packet);
+        void format(const StopDataTransferPacket& packet);
+
+        /// Returns the packets formatted since the last clear(), as a whole
+        /// text and as one record per packet.
+        /// The views are invalidated by the next call to format() or clear().
+        const PrintBatch& batch();
+
+        size_t size() const;
+        bool empty() const;
+        void clear();
+
+    private:
+
+        void appendHeader(const PacketHeader& header);
+        void endRecord();
+        void appendHex(uint32_t value, int digits);
+        void appendDecimal(uint32_t value);
+        void appendBool(bool value);
+        void append(std::string_view str);
+
+        bool m_swapByteOrder{false};
+        std::string m_buffer;
+        std::vector<size_t> m_recordOffsets;
+        PrintBatch m_batch;
+    };
+
+} // namespace Logi
@@ -1,36 +1,20 @@
 #include "PacketGenerator.hpp"
-#include <iostream>
-#include <iomanip>
-#include <sstream>
-
-template<class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
-template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+#include "PacketEncoder.hpp"
+#include "PacketStream.hpp"
+#include "WireFormat.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
 
 namespace Logi
 {
     namespace{
-        auto matchEndianess = [](Endianess a, Endianess b) -> bool
+        // The total payload size of the start packet is a 32-bit field
+        void checkTransferSize(size_t size)
         {
-            return static_cast<bool>(a) || static_cast<bool>(b);
-        };
-
-        std::ostream& formatHeader(std::ostream& os, const PacketHeader& header, uint16_t sequenceId)
-        {
-            auto convert = [](PacketType type) -> std::string {
-                switch (type)
-                {
-                case PacketType::Data:              return "Data";
-                case PacketType::StartDataTransfer: return "StartDataTransfer";
-                case PacketType::StopDataTransfer:  return "StopDataTransfer";
-                }
-                return "";
-            };
-
-            os << "software id: " << "0x" << std::setfill('0') << std::setw(2) << std::uppercase << std::hex << +header.softwareId << "\n";
-            os << "sequence id: " << "0x" << std::setfill('0') << std::setw(4) << std::uppercase << std::hex << sequenceId << "\n";
-            os << "packet type: " << convert(static_cast<PacketType>(header.packetType)) << "\n";
-            return os;
-        };
+            if (size > PacketGenerator::s_maxTransferBytes)
+                throw std::length_error("transfer larger than 4 GiB, it has to be segmented");
+        }
     }
 
     PacketGenerator::PacketGenerator(uint8_t softwareId, IPrinter& printer) 
@@ -39,92 +23,243 @@ namespace Logi
 
     PacketGenerator::PacketGenerator(uint8_t softwareId, Endianess endianess, IPrinter& printer) 
         : m_softwareId{softwareId} 
-        , m_swapByteOrder{matchEndianess(checkHostEndianess(), endianess)}
+        , m_swapByteOrder{swapByteOrder(endianess)}
         , m_printer{printer}
+        , m_formatter{m_swapByteOrder}
     {}
 
     Packets PacketGenerator::createPackets(const std::byte* buffer, size_t size, const EndPacketFlags& flags)
     {
+        checkTransferSize(size);
+
         Packets packets;
+        dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            createPacketsImpl<decltype(byteOrder)::value>(buffer, size, flags, packets);
+        });
+        return packets;
+    }
+        
+    Packets PacketGenerator::createPackets(const std::vector<std::byte>& buffer, const EndPacketFlags& flags)
+    {
+        return createPackets(buffer.data(), buffer.size(), flags);
+    }
+
+    PmrPackets PacketGenerator::createPackets(const std::byte* buffer, size_t size, const EndPacketFlags& flags, std::pmr::memory_resource* resource)
+    {
+        checkTransferSize(size);
+
+        PmrPackets packets{resource};
+        dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            createPacketsImpl<decltype(byteOrder)::value>(buffer, size, flags, packets);
+        });
+        return packets;
+    }
+
+    PacketArray PacketGenerator::createPackets(const std::byte* buffer, size_t size, const EndPacketFlags& flags, unsigned int threadCount)
+    {
+        checkTransferSize(size);
+
+        return dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return createPacketsImpl<decltype(byteOrder)::value>(buffer, size, flags, threadCount);
+        });
+    }
+
+    PacketViews PacketGenerator::createPacketViews(const std::byte* buffer, size_t size, const EndPacketFlags& flags)
+    {
+        checkTransferSize(size);
+
+        return dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return createPacketViewsImpl<decltype(byteOrder)::value>(buffer, size, flags);
+        });
+    }
+
+    Packets PacketGenerator::createSegmentedPackets(const std::byte* buffer, size_t size, const EndPacketFlags& flags, size_t maxSegmentBytes)
+    {
+        Packets packets;
+        PacketStream stream{*this, buffer, size, flags, maxSegmentBytes};
+        while (auto packet = stream.next())
+        {
+            packets.emplace_back(*packet);
+        }
+        return packets;
+    }
+
+    size_t PacketGenerator::serializedSize(size_t size)
+    {
+        auto dataPackets = (size + s_maxDataBytes - 1) / s_maxDataBytes;
+        return startPacketWireSize + dataPackets * dataPacketWireOverhead + size + stopPacketWireSize;
+    }
+
+    size_t PacketGenerator::serialize(const std::byte* buffer, size_t size, const EndPacketFlags& flags, std::byte* out, size_t outSize)
+    {
+        checkTransferSize(size);
+        if (outSize < serializedSize(size))
+            throw std::length_error("output buffer too small for the serialized transfer");
+
+        auto end = dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return serializeImpl<decltype(byteOrder)::value>(buffer, size, flags, out);
+        });
+        return end - out;
+    }
+
+    std::vector<std::byte> PacketGenerator::serialize(const std::vector<std::byte>& buffer, const EndPacketFlags& flags)
+    {
+        std::vector<std::byte> out(serializedSize(buffer.size()));
+        serialize(buffer.data(), buffer.size(), flags, out.data(), out.size());
+        return out;
+    }
+
+    template<Endianess ByteOrder, typename Container>
+    void PacketGenerator::createPacketsImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags, Container& packets)
+    {
+        packets.reserve((size + s_maxDataBytes - 1) / s_maxDataBytes + 2);
 
         packets.emplace_back(createPacket(size));  // start transfer packet
 
-        auto remainingBytes = size;
-        for (size_t offset = 0; offset < size; offset += 59)
-        {   
-            if (remainingBytes > s_maxDataBytes) 
-            {
-                packets.emplace_back(createPacket(s_maxDataBytes, buffer + offset)); // data packet
-                remainingBytes -= s_maxDataBytes;
-            }
-            else
+        auto sequenceId = m_packetSequenceId;
+        for (size_t offset = 0; offset < size; offset += s_maxDataBytes)
+        {
+            auto payloadSize = static_cast<uint8_t>(std::min<size_t>(size - offset, s_maxDataBytes));
+            packets.emplace_back(createPacket<ByteOrder>(payloadSize, buffer + offset, sequenceId++)); // data packet
+        }
+        m_packetSequenceId = sequenceId;
+
+        packets.emplace_back(createPacket(flags));  // end transfer packet
+    }
+
+    template<Endianess ByteOrder>
+    PacketArray PacketGenerator::createPacketsImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags, unsigned int threadCount)
+    {
+        auto dataPackets = (size + s_maxDataBytes - 1) / s_maxDataBytes;
+
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = static_cast<unsigned int>(std::clamp<size_t>(dataPackets / s_minPacketsPerThread, 1, threadCount));
+
+        PacketArray packets(dataPackets + 2);  // storage only, each packet is constructed once below
+
+        packets.construct(0, createPacket(size));  // start transfer packet
+
+        // Sequence ids of the data packets only depend on their index
+        auto firstSequenceId = m_packetSequenceId;
+        auto createRange = [&](size_t first, size_t last)
+        {
+            for (size_t index = first; index < last; index++)
             {
-                packets.emplace_back(createPacket(remainingBytes, buffer + offset)); // data packet
+                auto offset = index * s_maxDataBytes;
+                auto payloadSize = static_cast<uint8_t>(std::min<size_t>(size - offset, s_maxDataBytes));
+                auto sequenceId = static_cast<uint16_t>(firstSequenceId + index);
+                packets.construct(index + 1, createPacket<ByteOrder>(payloadSize, buffer + offset, sequenceId)); // data packet
             }
+        };
+
+        auto packetsPerThread = (dataPackets + threadCount - 1) / threadCount;
+        std::vector<std::thread> workers;
+        for (unsigned int thread = 1; thread < threadCount; thread++)
+        {
+            auto first = std::min(thread * packetsPerThread, dataPackets);
+            auto last = std::min(first + packetsPerThread, dataPackets);
+            workers.emplace_back(createRange, first, last);
         }
+        createRange(0, std::min(packetsPerThread, dataPackets));
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        m_packetSequenceId = static_cast<uint16_t>(firstSequenceId + dataPackets);
+
+        packets.construct(dataPackets + 1, createPacket(flags));  // end transfer packet
+
+        return packets;
+    }
+
+    template<Endianess ByteOrder>
+    PacketViews PacketGenerator::createPacketViewsImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags)
+    {
+        PacketViews packets;
+        packets.reserve((size + s_maxDataBytes - 1) / s_maxDataBytes + 2);
+
+        packets.emplace_back(createPacket(size));  // start transfer packet
+
+        auto sequenceId = m_packetSequenceId;
+        for (size_t offset = 0; offset < size; offset += s_maxDataBytes)
+        {
+            DataPacketView packet;
+            packet.header = createHeader<ByteOrder>(PacketType::Data, sequenceId++);
+            packet.payloadSize = static_cast<uint8_t>(std::min<size_t>(size - offset, s_maxDataBytes));
+            packet.data = buffer + offset;
+            packets.emplace_back(packet); // data packet
+        }
+        m_packetSequenceId = sequenceId;
 
         packets.emplace_back(createPacket(flags));  // end transfer packet
-        
+
         return packets;
     }
-        
-    Packets PacketGenerator::createPackets(const std::vector<std::byte>& buffer, const EndPacketFlags& flags)
+
+    template<Endianess ByteOrder>
+    std::byte* PacketGenerator::serializeImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags, std::byte* out)
     {
-        return createPackets(buffer.data(), buffer.size(), flags);
+        out = writePacket(out, createPacket(size));  // start transfer packet
+
+        auto sequenceId = m_packetSequenceId;
+        for (size_t offset = 0; offset < size; offset += s_maxDataBytes)
+        {
+            auto payloadSize = static_cast<uint8_t>(std::min<size_t>(size - offset, s_maxDataBytes));
+            out = writeDataPacket(out, createHeader<ByteOrder>(PacketType::Data, sequenceId++), payloadSize, buffer + offset); // data packet
+        }
+        m_packetSequenceId = sequenceId;
+
+        return writePacket(out, createPacket(flags));  // end transfer packet
     }
 
-    PacketHeader PacketGenerator::createPacket(PacketType type)
+    template<Endianess ByteOrder>
+    PacketHeader PacketGenerator::createHeader(PacketType type, uint16_t sequenceId) const
     {
         PacketHeader packet;
         packet.softwareId = m_softwareId;
         packet.packetType = static_cast<uint8_t>(type);
+        PacketEncoder<ByteOrder>::writeSequenceId(packet, sequenceId);
+        return packet;
+    }
 
-        if (m_swapByteOrder) 
-        {
-            packet.sequenceId_0 = m_packetSequenceId >> 8;
-            packet.sequenceId_1 = m_packetSequenceId & 0xFF;
-        }
-        else
-        {
-            packet.sequenceId_0 = m_packetSequenceId & 0xFF;
-            packet.sequenceId_1 = m_packetSequenceId >> 8;
-        }
+    template<Endianess ByteOrder>
+    DataPacket PacketGenerator::createPacket(uint8_t payloadSize, const std::byte* data, uint16_t sequenceId) const
+    {
+        DataPacket packet;
+        packet.header = createHeader<ByteOrder>(PacketType::Data, sequenceId);
+        packet.payloadSize = payloadSize;
+        std::copy_n(data, payloadSize, packet.data.begin());
+        return packet;
+    }
 
+    PacketHeader PacketGenerator::createPacket(PacketType type)
+    {
+        auto packet = dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return createHeader<decltype(byteOrder)::value>(type, m_packetSequenceId);
+        });
         incrementSequenceId();
-
         return packet;
     }
 
-
     StartDataTransferPacket PacketGenerator::createPacket(uint32_t totalPayloadSize)
     {
         StartDataTransferPacket packet;
         packet.header = createPacket(PacketType::StartDataTransfer);
-        
-        if (m_swapByteOrder) 
-        {
-            packet.totalPayloadSize_0 = totalPayloadSize >> 24;
-            packet.totalPayloadSize_1 = totalPayloadSize >> 16;
-            packet.totalPayloadSize_2 = totalPayloadSize >> 8;
-            packet.totalPayloadSize_3 = totalPayloadSize & 0xFF;
-        }
-        else
-        {
-            packet.totalPayloadSize_0 = totalPayloadSize & 0xFF;
-            packet.totalPayloadSize_1 = totalPayloadSize >> 8;
-            packet.totalPayloadSize_2 = totalPayloadSize >> 16;
-            packet.totalPayloadSize_3 = totalPayloadSize >> 24;
-        }
-
+        dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            PacketEncoder<decltype(byteOrder)::value>::writeTotalPayloadSize(packet, totalPayloadSize);
+        });
         return packet;
     }
 
     DataPacket PacketGenerator::createPacket(uint8_t payloadSize, const std::byte* data)
     {
-        DataPacket packet;
-        packet.header = createPacket(PacketType::Data);
-        packet.payloadSize = payloadSize;
-        packet.data.insert(packet.data.begin(), &data[0], &data[payloadSize]);
+        auto packet = dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return createPacket<decltype(byteOrder)::value>(payloadSize, data, m_packetSequenceId);
+        });
+        incrementSequenceId();
         return packet;
     }
 
@@ -140,53 +275,41 @@ namespace Logi
 
     void PacketGenerator::printPackets(const Packets& packets)
     {
-        for (const auto& packet : packets)
-        {
-            std::visit(overloaded {
-                [this](const DataPacket& packet)              { printPacket(packet); },
-                [this](const StartDataTransferPacket& packet) { printPacket(packet); },
-                [this](const StopDataTransferPacket& packet)  { printPacket(packet); }
-            }, packet);
-        }
-    };
+        printPacketRange(packets);
+    }
 
-    void PacketGenerator::printPacket(const StartDataTransferPacket& packet)
+    void PacketGenerator::printPackets(const PacketViews& packets)
     {
-        auto sequenceId = readField16(packet.header.sequenceId_0, packet.header.sequenceId_1, m_swapByteOrder);
-        auto totalSize = readField32(
-            packet.totalPayloadSize_0,
-            packet.totalPayloadSize_1,
-            packet.totalPayloadSize_2,
-            packet.totalPayloadSize_3,
-            m_swapByteOrder
-        );
-
-        std::ostringstream oss;
-        formatHeader(oss, packet.header, sequenceId);
-        oss << "total payload size: " << std::dec << +totalSize << "\n";
-        m_printer.print(oss.str());
+        printPacketRange(packets);
     }
 
-    void PacketGenerator::printPacket(const DataPacket& packet)
+    void PacketGenerator::printPackets(const PmrPackets& packets)
     {
-        auto sequenceId = readField16(packet.header.sequenceId_0, packet.header.sequenceId_1, m_swapByteOrder);
+        printPacketRange(packets);
+    }
 
-        std::ostringstream oss;
-        formatHeader(oss, packet.header, sequenceId);
-        oss << "payload size: " << std::dec << +packet.payloadSize << "\n";
-        m_printer.print(oss.str());
+    void PacketGenerator::printPackets(const PacketArray& packets)
+    {
+        printPacketRange(packets);
     }
-    
-    void PacketGenerator::printPacket(const StopDataTransferPacket& packet)
+
+    template<typename Range>
+    void PacketGenerator::printPacketRange(const Range& packets)
     {
-        auto sequenceId = readField16(packet.header.sequenceId_0, packet.header.sequenceId_1, m_swapByteOrder);
+        m_formatter.clear();
+        for (const auto& packet : packets)
+        {
+            std::visit([this](const auto& packet) { m_formatter.format(packet); }, packet);
+
+            if (m_formatter.size() >= s_printBatchBytes)
+            {
+                m_printer.printBatch(m_formatter.batch());
+                m_formatter.clear();
+            }
+        }
 
-        std::ostringstream oss;
-        formatHeader(oss, packet.header, sequenceId);
-        oss << "test: " << (readBit(packet.flags, 2) ? "true" : "false") << "\n";
-        oss << "verify: " << (readBit(packet.flags, 1) ? "true" : "false") << "\n";
-        oss << "reboot: " << (readBit(packet.flags, 0) ? "true" : "false") << "\n";
-        m_printer.print(oss.str());
+        if (!m_formatter.empty())
+            m_printer.printBatch(m_formatter.batch());
     }
 
     void PacketGenerator::incrementSequenceId()
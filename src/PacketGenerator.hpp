@@ -2,22 +2,36 @@
 
 #include "IPrinter.hpp"
 #include "Packet.hpp"
+#include "PacketArray.hpp"
+#include "PacketFormatter.hpp"
 #include "Utils.hpp"
 #include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <variant>
 
 namespace Logi
 {
-    using PacketVariant = std::variant<StartDataTransferPacket, DataPacket, StopDataTransferPacket>;
     using Packets = std::vector<PacketVariant>;
+    using PmrPackets = std::pmr::vector<PacketVariant>;
+    using PacketViewVariant = std::variant<StartDataTransferPacket, DataPacketView, StopDataTransferPacket>;
+    using PacketViews = std::vector<PacketViewVariant>;
 
     class PacketGenerator
     {
     public:
-        static constexpr int s_maxDataBytes = 59;
+        static constexpr int s_maxDataBytes = maxPayloadSize;
+        static constexpr size_t s_minPacketsPerThread = 4096;
+        static constexpr size_t s_printBatchBytes = 64 * 1024;
+
+        /// Largest payload of a single transfer, its size being a 32-bit field.
+        static constexpr size_t s_maxTransferBytes = 0xFFFFFFFF;
+
+        /// Largest payload of a transfer whose sequence ids do not wrap around,
+        /// a segment size for receivers that require unique sequence ids.
+        static constexpr size_t s_maxUniqueSequenceBytes = (0x10000 - 2) * maxPayloadSize;
 
         PacketGenerator(uint8_t softwareId, IPrinter& printer);
         PacketGenerator(uint8_t softwareId, Endianess endianess, IPrinter& printer);
@@ -35,26 +49,107 @@ namespace Logi
         /// \return The generated packets
         Packets createPackets(const std::vector<std::byte>& buffer, const EndPacketFlags& flags);
 
+        /// Creates packets for the input data, allocating them from the memory resource.
+        ///
+        /// With a std::pmr::monotonic_buffer_resource the whole transfer is
+        /// released at once when the resource is destroyed.
+        ///
+        /// \param buffer The buffer containing data to be encoded.
+        /// \param size The size of the buffer.
+        /// \param resource The memory resource providing the packets storage.
+        /// \return The generated packets.
+        PmrPackets createPackets(const std::byte* buffer, size_t size, const EndPacketFlags& flags, std::pmr::memory_resource* resource);
+
+        /// Creates packets for the input data using several threads.
+        ///
+        /// Each thread constructs the data packets of its own index range in
+        /// place, the sequence ids being derived from the packet index, so the
+        /// output is written once and not by the calling thread alone. Threads
+        /// are only started for at least s_minPacketsPerThread data packets each.
+        ///
+        /// \param buffer The buffer containing data to be encoded.
+        /// \param size The size of the buffer.
+        /// \param threadCount The maximum number of threads, 0 to use the hardware concurrency.
+        /// \return The generated packets.
+        PacketArray createPackets(const std::byte* buffer, size_t size, const EndPacketFlags& flags, unsigned int threadCount);
+
+        /// Creates packets for input data of any size, split into consecutive
+        /// transfers of at most maxSegmentBytes each.
+        ///
+        /// Sequence ids continue from one transfer to the next. Only the last
+        /// stop packet carries the flags, the intermediate ones have none.
+        ///
+        /// \param buffer The buffer containing data to be encoded.
+        /// \param size The size of the buffer.
+        /// \param maxSegmentBytes The maximum payload of each transfer, up to s_maxTransferBytes.
+        /// \return The generated packets.
+        Packets createSegmentedPackets(const std::byte* buffer, size_t size, const EndPacketFlags& flags, size_t maxSegmentBytes = s_maxTransferBytes);
+
+        /// Creates packets for the input data without copying the payload.
+        ///
+        /// The data packets reference the input buffer, which must outlive them.
+        ///
+        /// \param buffer The buffer containing data to be encoded.
+        /// \param size The size of the buffer.
+        /// \return The generated packets.
+        PacketViews createPacketViews(const std::byte* buffer, size_t size, const EndPacketFlags& flags);
+
+        /// Returns the number of bytes needed to serialize a transfer.
+        ///
+        /// \param size The size of the data to be encoded.
+        /// \return The size of the serialized transfer.
+        static size_t serializedSize(size_t size);
+
+        /// Encodes the packets for the input data in their on-wire layout.
+        ///
+        /// \param buffer The buffer containing data to be encoded.
+        /// \param size The size of the buffer.
+        /// \param out The destination buffer.
+        /// \param outSize The size of the destination, at least serializedSize(size).
+        /// \return The number of bytes written.
+        size_t serialize(const std::byte* buffer, size_t size, const EndPacketFlags& flags, std::byte* out, size_t outSize);
+
+        /// Encodes the packets for the input data in their on-wire layout.
+        ///
+        /// \param buffer The buffer containing data to be encoded.
+        /// \return The serialized transfer.
+        std::vector<std::byte> serialize(const std::vector<std::byte>& buffer, const EndPacketFlags& flags);
+
         /// Prints the input packets.
         ///
+        /// The text of consecutive packets is gathered and handed to the printer
+        /// with one printBatch call per s_printBatchBytes of text.
+        ///
         /// \param packets The packets to be print.
         void printPackets(const Packets& packets);
+        void printPackets(const PacketViews& packets);
+        void printPackets(const PmrPackets& packets);
+        void printPackets(const PacketArray& packets);
 
     private:
 
+        friend class PacketStream;
+        friend class SharedMemorySink;
+
+        template<Endianess ByteOrder, typename Container> void createPacketsImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags, Container& packets);
+        template<Endianess ByteOrder> PacketArray createPacketsImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags, unsigned int threadCount);
+        template<Endianess ByteOrder> PacketViews createPacketViewsImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags);
+        template<Endianess ByteOrder> std::byte* serializeImpl(const std::byte* buffer, size_t size, const EndPacketFlags& flags, std::byte* out);
+        template<Endianess ByteOrder> PacketHeader createHeader(PacketType type, uint16_t sequenceId) const;
+        template<Endianess ByteOrder> DataPacket createPacket(uint8_t payloadSize, const std::byte* data, uint16_t sequenceId) const;
+
         PacketHeader createPacket(PacketType type);
         StartDataTransferPacket createPacket(uint32_t totalPayloadSize);
         DataPacket createPacket(uint8_t payloadSize, const std::byte* data);
         StopDataTransferPacket createPacket(const EndPacketFlags& flags);
-        void printPacket(const StartDataTransferPacket& packet);
-        void printPacket(const DataPacket& packet);
-        void printPacket(const StopDataTransferPacket& packet);
+        template<typename Range> void printPacketRange(const Range& packets);
         void incrementSequenceId();
 
         uint8_t m_softwareId{0};
         uint16_t m_packetSequenceId{0};
         bool m_swapByteOrder{false};
         IPrinter& m_printer;
+        PacketFormatter m_formatter;
     };
 
 } // namespace Logi
\ No newline at end of file
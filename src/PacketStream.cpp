@@ -0,0 +1,60 @@
+#include "PacketStream.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Logi
+{
+    PacketStream::PacketStream(PacketGenerator& generator, const std::byte* buffer, size_t size, const EndPacketFlags& flags, size_t maxSegmentBytes)
+        : m_generator{generator}
+        , m_buffer{buffer}
+        , m_size{size}
+        , m_maxSegmentBytes{maxSegmentBytes}
+        , m_flags{flags}
+    {
+        if (maxSegmentBytes == 0 || maxSegmentBytes > PacketGenerator::s_maxTransferBytes)
+            throw std::invalid_argument("segment size must be between 1 byte and 4 GiB");
+    }
+
+    std::optional<PacketVariant> PacketStream::next()
+    {
+        switch (m_state)
+        {
+        case State::Start:
+        {
+            auto segmentSize = std::min(m_size - m_offset, m_maxSegmentBytes);
+            m_segmentEnd = m_offset + segmentSize;
+            m_state = (segmentSize > 0) ? State::Data : State::Stop;
+            return m_generator.createPacket(static_cast<uint32_t>(segmentSize));  // start transfer packet
+        }
+
+        case State::Data:
+        {
+            auto payloadSize = static_cast<uint8_t>(std::min<size_t>(m_segmentEnd - m_offset, PacketGenerator::s_maxDataBytes));
+            auto packet = m_generator.createPacket(payloadSize, m_buffer + m_offset);  // data packet
+            m_offset += payloadSize;
+            if (m_offset >= m_segmentEnd)
+                m_state = State::Stop;
+            return packet;
+        }
+
+        case State::Stop:
+            if (m_offset < m_size)
+            {
+                m_state = State::Start;
+                return m_generator.createPacket(EndPacketFlags{});  // end of an intermediate transfer
+            }
+            m_state = State::Done;
+            return m_generator.createPacket(m_flags);  // end transfer packet
+
+        case State::Done:
+            break;
+        }
+        return std::nullopt;
+    }
+
+    bool PacketStream::done() const
+    {
+        return m_state == State::Done;
+    }
+
+} // namespace Logi
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "PacketGenerator.hpp"
+#include <cstddef>
+#include <optional>
+
+namespace Logi
+{
+    /// Produces the packets of a transfer one at a time instead of
+    /// materializing the whole Packets vector.
+    ///
+    /// Inputs larger than maxSegmentBytes are split into consecutive transfers,
+    /// each with its own start and stop packet. Only the last stop packet
+    /// carries the flags. By default inputs are only split when the 32-bit
+    /// total payload size cannot describe them, the sequence ids wrapping
+    /// around within a transfer like with createPackets().
+    ///
+    /// Sequence ids are taken from the generator as packets are pulled, so the
+    /// generator must not be used for another transfer until the stream is done.
+    /// The input buffer must outlive the stream.
+    class PacketStream
+    {
+    public:
+
+        PacketStream(PacketGenerator& generator, const std::byte* buffer, size_t size, const EndPacketFlags& flags,
+            size_t maxSegmentBytes = PacketGenerator::s_maxTransferBytes);
+
+        /// Creates the next packet of the transfer.
+        ///
+        /// \return The packet, or nothing once the stop packet has been returned.
+        std::optional<PacketVariant> next();
+
+        /// Returns whether all packets of the transfer have been produced.
+        bool done() const;
+
+    private:
+
+        enum class State
+        {
+            Start,
+            Data,
+            Stop,
+            Done
+        };
+
+        PacketGenerator& m_generator;
+        const std::byte* m_buffer{nullptr};
+        size_t m_size{0};
+        size_t m_offset{0};
+        size_t m_segmentEnd{0};
+        size_t m_maxSegmentBytes{0};
+        EndPacketFlags m_flags;
+        State m_state{State::Start};
+    };
+
+} // namespace Logi
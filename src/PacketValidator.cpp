@@ -0,0 +1,96 @@
+#include "PacketValidator.hpp"
+#include "Packet.hpp"
+#include "PacketEncoder.hpp"
+#include "WireFormat.hpp"
+#include <array>
+#include <cstring>
+
+namespace Logi
+{
+    namespace{
+        // The header and payload size of a data packet, in wire order
+        using PacketPrefix = std::array<uint8_t, 8>;
+
+        uint64_t loadWord(const void* bytes)
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes, sizeof(word));
+            return word;
+        }
+
+        template<Endianess ByteOrder>
+        PacketPrefix packetPrefix(uint8_t softwareId, uint16_t sequenceId, uint8_t payloadSize)
+        {
+            PacketHeader header;
+            header.softwareId = softwareId;
+            header.packetType = static_cast<uint8_t>(PacketType::Data);
+            PacketEncoder<ByteOrder>::writeSequenceId(header, sequenceId);
+            return {header.softwareId, header.sequenceId_0, header.sequenceId_1, header.packetType, payloadSize, 0, 0, 0};
+        }
+    }
+
+    PacketValidator::PacketValidator(uint8_t softwareId, Endianess endianess)
+        : m_softwareId{softwareId}
+        , m_swapByteOrder{swapByteOrder(endianess)}
+    {}
+
+    std::optional<size_t> PacketValidator::findInvalidPacket(const std::byte* data, size_t size) const
+    {
+        return dispatchByteOrder(m_swapByteOrder, [&](auto byteOrder) {
+            return findInvalidPacketImpl<decltype(byteOrder)::value>(data, size);
+        });
+    }
+
+    template<Endianess ByteOrder>
+    std::optional<size_t> PacketValidator::findInvalidPacketImpl(const std::byte* data, size_t size) const
+    {
+        if (size == 0)
+            return std::nullopt;
+        if (size < dataPacketWireOverhead)
+            return 0;
+
+        // Only the 5 bytes of header and payload size are compared
+        static const PacketPrefix maskBytes{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0};
+        const auto mask = loadWord(maskBytes.data());
+
+        auto sequenceId = PacketEncoder<ByteOrder>::readSequenceId(readHeader(data));
+        size_t offset = 0;
+        size_t index = 0;
+        while (offset < size)
+        {
+            auto remaining = size - offset;
+            auto in = data + offset;
+
+            if (remaining >= maxPacketWireSize)
+            {
+                auto expected = loadWord(packetPrefix<ByteOrder>(m_softwareId, sequenceId, maxPayloadSize).data());
+                if ((loadWord(in) & mask) == expected)
+                {
+                    offset += maxPacketWireSize;
+                    index++;
+                    sequenceId++;
+                    continue;
+                }
+            }
+
+            // Last packet of a transfer, or an invalid one
+            if (remaining < dataPacketWireOverhead)
+                return index;
+
+            auto header = readHeader(in);
+            auto payloadSize = static_cast<uint8_t>(in[headerWireSize]);
+            if (header.softwareId != m_softwareId ||
+                header.packetType != static_cast<uint8_t>(PacketType::Data) ||
+                PacketEncoder<ByteOrder>::readSequenceId(header) != sequenceId ||
+                payloadSize == 0 || payloadSize > maxPayloadSize ||
+                remaining < dataPacketWireOverhead + payloadSize)
+                return index;
+
+            offset += dataPacketWireOverhead + payloadSize;
+            index++;
+            sequenceId++;
+        }
+        return std::nullopt;
+    }
+
+} // namespace Logi
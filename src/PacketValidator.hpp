@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Utils.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Logi
+{
+    /// Checks runs of serialized data packets in bulk, e.g. the data packets of
+    /// a captured trace.
+    ///
+    /// Every packet must carry the expected software id and the data packet
+    /// type, a payload of 1 to maxPayloadSize bytes, and the sequence id
+    /// following the one of the previous packet (wrapping around after 0xFFFF).
+    /// The first packet sets the starting sequence id.
+    ///
+    /// Full packets, which make up all but the last packet of a transfer, are
+    /// checked with a single 64-bit compare of their header and payload size.
+    class PacketValidator
+    {
+    public:
+
+        explicit PacketValidator(uint8_t softwareId, Endianess endianess = Endianess::LittleEndian);
+
+        /// Finds the first invalid data packet.
+        ///
+        /// \param data The serialized data packets, back to back.
+        /// \param size The size of the data.
+        /// \return The index of the first invalid or truncated packet, or nothing if all are valid.
+        std::optional<size_t> findInvalidPacket(const std::byte* data, size_t size) const;
+
+    private:
+
+        template<Endianess ByteOrder> std::optional<size_t> findInvalidPacketImpl(const std::byte* data, size_t size) const;
+
+        uint8_t m_softwareId{0};
+        bool m_swapByteOrder{false};
+    };
+
+} // namespace Logi
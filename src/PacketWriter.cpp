@@ -0,0 +1,125 @@
+#include "PacketWriter.hpp"
+#include "SystemError.hpp"
+#include "WireFormat.hpp"
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace Logi
+{
+    static_assert(PacketWriter::s_maxIovecs <= IOV_MAX, "writev cannot take that many slices");
+
+    PacketWriter::PacketWriter(const std::string& path)
+        : PacketWriter(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+    {
+        if (m_fd < 0)
+            throwSystemError("cannot open " + path);
+        m_ownsFd = true;
+    }
+
+    PacketWriter::PacketWriter(int fd)
+        : m_fd{fd}
+        , m_headers(s_maxIovecs * startPacketWireSize)  // largest encoded header per slice
+    {
+        m_iovecs.reserve(s_maxIovecs);
+    }
+
+    PacketWriter::~PacketWriter()
+    {
+        if (m_ownsFd)
+            ::close(m_fd);
+    }
+
+    size_t PacketWriter::write(const PacketViews& packets)
+    {
+        size_t written = 0;
+        for (const auto& packet : packets)
+        {
+            // A data packet takes two slices, merged headers take arena room but no slice
+            if (m_iovecs.size() + 2 > s_maxIovecs || m_headersSize + startPacketWireSize > m_headers.size())
+                written += flush();
+
+            std::visit([this](const auto& packet) { append(packet); }, packet);
+        }
+        return written + flush();
+    }
+
+    void PacketWriter::append(const StartDataTransferPacket& packet)
+    {
+        appendHeader(writePacket(m_headers.data() + m_headersSize, packet));
+    }
+
+    void PacketWriter::append(const DataPacketView& packet)
+    {
+        auto end = writeHeader(m_headers.data() + m_headersSize, packet.header);
+        *end++ = static_cast<std::byte>(packet.payloadSize);
+        appendHeader(end);
+        appendSlice(packet.data, packet.payloadSize);
+    }
+
+    void PacketWriter::append(const StopDataTransferPacket& packet)
+    {
+        appendHeader(writePacket(m_headers.data() + m_headersSize, packet));
+    }
+
+    void PacketWriter::appendHeader(const std::byte* end)
+    {
+        auto header = m_headers.data() + m_headersSize;
+        m_headersSize = end - m_headers.data();
+        appendSlice(header, end - header);
+    }
+
+    void PacketWriter::appendSlice(const std::byte* data, size_t size)
+    {
+        // Consecutive headers, e.g. of the start and first data packet, share a slice
+        if (!m_iovecs.empty())
+        {
+            auto& last = m_iovecs.back();
+            if (static_cast<const std::byte*>(last.iov_base) + last.iov_len == data)
+            {
+                last.iov_len += size;
+                return;
+            }
+        }
+        m_iovecs.push_back({const_cast<std::byte*>(data), size});
+    }
+
+    size_t PacketWriter::flush()
+    {
+        size_t total = 0;
+        auto slices = m_iovecs.data();
+        auto count = m_iovecs.size();
+        while (count > 0)
+        {
+            auto written = ::writev(m_fd, slices, static_cast<int>(count));
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throwSystemError("cannot write packets");
+            }
+            total += written;
+
+            // Skip what was written, a short write can stop in the middle of a slice
+            auto remaining = static_cast<size_t>(written);
+            while (count > 0 && remaining >= slices->iov_len)
+            {
+                remaining -= slices->iov_len;
+                slices++;
+                count--;
+            }
+            if (count > 0)
+            {
+                slices->iov_base = static_cast<std::byte*>(slices->iov_base) + remaining;
+                slices->iov_len -= remaining;
+            }
+        }
+
+        m_iovecs.clear();
+        m_headersSize = 0;
+        return total;
+    }
+
+} // namespace Logi
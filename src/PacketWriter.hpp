@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "PacketGenerator.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+
+namespace Logi
+{
+    /// Writes packets in their on-wire layout to a file descriptor with writev(),
+    /// without copying the payload.
+    ///
+    /// Each packet is gathered from its encoded header, kept in a small arena,
+    /// and for data packets the payload in the caller's buffer. Up to
+    /// s_maxIovecs slices are written per system call.
+    class PacketWriter
+    {
+    public:
+
+        static constexpr size_t s_maxIovecs = 1024;  // never more than IOV_MAX on Linux
+
+        /// Creates or truncates the file at path.
+        ///
+        /// \param path The path of the file to be written.
+        explicit PacketWriter(const std::string& path);
+
+        /// Writes to an already open file descriptor (file, pipe or socket), which is left open.
+        ///
+        /// \param fd The file descriptor to be written.
+        explicit PacketWriter(int fd);
+
+        /// Closes the file if it was opened by the writer.
+        ~PacketWriter();
+
+        PacketWriter(const PacketWriter&) = delete;
+        PacketWriter& operator=(const PacketWriter&) = delete;
+
+        /// Writes the packets.
+        ///
+        /// All bytes have been written when it returns, so the buffer referenced
+        /// by the data packets can be released afterwards.
+        ///
+        /// \param packets The packets to be written.
+        /// \return The number of bytes written.
+        size_t write(const PacketViews& packets);
+
+    private:
+
+        void append(const StartDataTransferPacket& packet);
+        void append(const DataPacketView& packet);
+        void append(const StopDataTransferPacket& packet);
+        void appendHeader(const std::byte* end);
+        void appendSlice(const std::byte* data, size_t size);
+        size_t flush();
+
+        int m_fd{-1};
+        bool m_ownsFd{false};
+        std::vector<std::byte> m_headers;
+        size_t m_headersSize{0};
+        std::vector<iovec> m_iovecs;
+    };
+
+} // namespace Logi
@@ -0,0 +1,364 @@
+#include "SharedMemoryRing.hpp"
+#include "SystemError.hpp"
+#include "WireFormat.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace Logi
+{
+    /// Start of the shared memory, followed by the ring bytes.
+    ///
+    /// Each side waits on the event counter the other side bumps, after
+    /// announcing itself in its waiting flag. Positions only grow, the ring
+    /// offset being the position modulo the capacity.
+    struct SharedMemoryRing::Control
+    {
+        alignas(64) std::atomic<uint64_t> writePosition{0};
+        std::atomic<uint32_t> writeEvent{0};
+        std::atomic<uint32_t> readerWaiting{0};
+        std::atomic<uint32_t> closed{0};
+
+        alignas(64) std::atomic<uint64_t> readPosition{0};
+        std::atomic<uint32_t> readEvent{0};
+        std::atomic<uint32_t> writerWaiting{0};
+
+        alignas(64) uint64_t capacity{0};
+        std::atomic<uint32_t> ready{0};  // s_readyMagic once initialized
+    };
+
+    namespace{
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring positions are shared between processes");
+
+        constexpr uint32_t s_readyMagic = 0x4C4F4749;  // "LOGI"
+
+        void futexWait(std::atomic<uint32_t>& word, uint32_t value)
+        {
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, value, nullptr, nullptr, 0);
+        }
+
+        void futexWake(std::atomic<uint32_t>& word)
+        {
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+        }
+
+        /// Bumps the event and wakes the other side up if it announced it waits.
+        void notify(std::atomic<uint32_t>& event, std::atomic<uint32_t>& waiting)
+        {
+            if (waiting.load())
+            {
+                event.fetch_add(1);
+                futexWake(event);
+            }
+        }
+
+        /// Waits until ready() holds, which is checked again after announcing
+        /// the wait so that a notification cannot be missed.
+        template<typename Ready>
+        void wait(std::atomic<uint32_t>& event, std::atomic<uint32_t>& waiting, Ready&& ready)
+        {
+            while (!ready())
+            {
+                auto value = event.load();
+                waiting.store(1);
+                if (!ready())
+                    futexWait(event, value);
+                waiting.store(0);
+            }
+        }
+    }
+
+    SharedMemoryRing SharedMemoryRing::create(const std::string& name, size_t capacity)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("shared memory ring capacity must not be 0");
+
+        FileDescriptor fd{::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600)};
+        if (fd.get() < 0)
+            throwSystemError("cannot create shared memory " + name);
+
+        auto size = sizeof(Control) + capacity;
+        if (::ftruncate(fd.get(), static_cast<off_t>(size)) < 0)
+        {
+            ::shm_unlink(name.c_str());
+            throwSystemError("cannot resize shared memory " + name);
+        }
+
+        auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+        if (address == MAP_FAILED)
+        {
+            ::shm_unlink(name.c_str());
+            throwSystemError("cannot map shared memory " + name);
+        }
+
+        // The name is already visible, openers wait for the ready marker
+        auto control = new (address) Control;
+        control->capacity = capacity;
+        control->ready.store(s_readyMagic, std::memory_order_release);
+        return SharedMemoryRing{address, size, name, true};
+    }
+
+    SharedMemoryRing SharedMemoryRing::open(const std::string& name)
+    {
+        FileDescriptor fd{::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0)};
+        if (fd.get() < 0)
+            throwSystemError("cannot open shared memory " + name);
+
+        struct stat status;
+        if (::fstat(fd.get(), &status) < 0)
+            throwSystemError("cannot read size of shared memory " + name);
+
+        auto size = static_cast<size_t>(status.st_size);
+        if (size <= sizeof(Control))
+            throw std::runtime_error("shared memory " + name + " is not a ring");
+
+        auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+        if (address == MAP_FAILED)
+            throwSystemError("cannot map shared memory " + name);
+
+        SharedMemoryRing ring{address, size, name, false};
+        auto& shared = ring.control();
+        if (shared.ready.load(std::memory_order_acquire) != s_readyMagic)
+            throw std::runtime_error("shared memory " + name + " is not an initialized ring");
+        if (shared.capacity != size - sizeof(Control))
+            throw std::runtime_error("shared memory " + name + " has an inconsistent ring capacity");
+        return ring;
+    }
+
+    SharedMemoryRing::SharedMemoryRing(void* address, size_t size, const std::string& name, bool owner)
+        : m_address{address}
+        , m_size{size}
+        , m_name{name}
+        , m_owner{owner}
+    {}
+
+    SharedMemoryRing::SharedMemoryRing(SharedMemoryRing&& other) noexcept
+        : m_address{std::exchange(other.m_address, nullptr)}
+        , m_size{std::exchange(other.m_size, 0)}
+        , m_name{std::move(other.m_name)}
+        , m_owner{std::exchange(other.m_owner, false)}
+    {}
+
+    SharedMemoryRing& SharedMemoryRing::operator=(SharedMemoryRing&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            m_address = std::exchange(other.m_address, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_name = std::move(other.m_name);
+            m_owner = std::exchange(other.m_owner, false);
+        }
+        return *this;
+    }
+
+    SharedMemoryRing::~SharedMemoryRing()
+    {
+        unmap();
+    }
+
+    void SharedMemoryRing::write(const std::byte* data, size_t size)
+    {
+        while (size > 0)
+        {
+            // Copy what fits, up to the end of the ring
+            size_t space;
+            auto out = reserve(1, space);
+            auto count = std::min(size, space);
+            std::memcpy(out, data, count);
+            commit(count);
+            data += count;
+            size -= count;
+        }
+    }
+
+    std::byte* SharedMemoryRing::reserve(size_t minSize, size_t& size)
+    {
+        auto& shared = control();
+        auto capacity = shared.capacity;
+
+        auto writePosition = shared.writePosition.load(std::memory_order_relaxed);
+        auto offset = writePosition % capacity;
+        auto wanted = std::min<uint64_t>(minSize, capacity - offset);
+        wait(shared.readEvent, shared.writerWaiting, [&] { return capacity - (writePosition - shared.readPosition.load()) >= wanted; });
+
+        auto space = capacity - (writePosition - shared.readPosition.load(std::memory_order_acquire));
+        size = std::min<uint64_t>(space, capacity - offset);
+        return ring() + offset;
+    }
+
+    void SharedMemoryRing::commit(size_t size)
+    {
+        auto& shared = control();
+        shared.writePosition.store(shared.writePosition.load(std::memory_order_relaxed) + size);
+        notify(shared.writeEvent, shared.readerWaiting);
+    }
+
+    size_t SharedMemoryRing::read(std::byte* out, size_t size)
+    {
+        auto& shared = control();
+        auto capacity = shared.capacity;
+
+        auto readPosition = shared.readPosition.load(std::memory_order_relaxed);
+        wait(shared.writeEvent, shared.readerWaiting, [&] {
+            return shared.writePosition.load() != readPosition || shared.closed.load();
+        });
+
+        auto available = shared.writePosition.load(std::memory_order_acquire) - readPosition;
+        auto count = std::min<uint64_t>(size, available);
+        auto offset = readPosition % capacity;
+        auto first = std::min<uint64_t>(count, capacity - offset);
+        std::memcpy(out, ring() + offset, first);
+        std::memcpy(out + first, ring(), count - first);
+
+        shared.readPosition.store(readPosition + count);
+        notify(shared.readEvent, shared.writerWaiting);
+        return count;
+    }
+
+    void SharedMemoryRing::close()
+    {
+        auto& shared = control();
+        shared.closed.store(1);
+        shared.writeEvent.fetch_add(1);
+        futexWake(shared.writeEvent);
+    }
+
+    size_t SharedMemoryRing::capacity() const
+    {
+        return control().capacity;
+    }
+
+    SharedMemoryRing::Control& SharedMemoryRing::control() const
+    {
+        return *static_cast<Control*>(m_address);
+    }
+
+    std::byte* SharedMemoryRing::ring() const
+    {
+        return static_cast<std::byte*>(m_address) + sizeof(Control);
+    }
+
+    void SharedMemoryRing::unmap()
+    {
+        if (m_address)
+            ::munmap(m_address, m_size);
+        if (m_owner)
+            ::shm_unlink(m_name.c_str());
+        m_address = nullptr;
+        m_size = 0;
+        m_owner = false;
+    }
+
+    SharedMemorySink::SharedMemorySink(SharedMemoryRing& ring)
+        : m_ring{ring}
+    {}
+
+    size_t SharedMemorySink::write(PacketGenerator& generator, const std::byte* buffer, size_t size, const EndPacketFlags& flags)
+    {
+        size_t written = 0;
+        size_t offset = 0;
+
+        // Segmented like PacketStream, only when the total payload size cannot describe the input
+        do
+        {
+            auto segmentEnd = offset + std::min(size - offset, PacketGenerator::s_maxTransferBytes);
+            auto start = generator.createPacket(static_cast<uint32_t>(segmentEnd - offset));
+            append(startPacketWireSize, [&](std::byte* out) { return writePacket(out, start); });  // start transfer packet
+            written += startPacketWireSize;
+
+            for (; offset < segmentEnd; offset += PacketGenerator::s_maxDataBytes)
+            {
+                auto payloadSize = static_cast<uint8_t>(std::min<size_t>(segmentEnd - offset, PacketGenerator::s_maxDataBytes));
+                auto header = generator.createPacket(PacketType::Data);
+                append(dataPacketWireOverhead + payloadSize, [&](std::byte* out) {
+                    return writeDataPacket(out, header, payloadSize, buffer + offset);  // data packet
+                });
+                written += dataPacketWireOverhead + payloadSize;
+            }
+
+            // Only the last stop packet carries the flags
+            auto stop = generator.createPacket(offset < size ? EndPacketFlags{} : flags);
+            append(stopPacketWireSize, [&](std::byte* out) { return writePacket(out, stop); });  // end transfer packet
+            written += stopPacketWireSize;
+        }
+        while (offset < size);
+
+        commit();
+        return written;
+    }
+
+    template<typename Serialize>
+    void SharedMemorySink::append(size_t packetSize, Serialize&& serialize)
+    {
+        if (packetSize > m_space)
+        {
+            commit();
+            m_out = m_ring.reserve(packetSize, m_space);
+            m_space = std::min(m_space, s_chunkBytes);
+            if (packetSize > m_space)
+            {
+                // The packet wraps around the end of the ring
+                std::byte packet[maxPacketWireSize];
+                serialize(packet);
+                m_ring.write(packet, packetSize);
+                m_space = 0;
+                return;
+            }
+        }
+
+        m_out = serialize(m_out);
+        m_space -= packetSize;
+        m_pending += packetSize;
+    }
+
+    void SharedMemorySink::commit()
+    {
+        if (m_pending > 0)
+            m_ring.commit(m_pending);
+        m_pending = 0;
+    }
+
+    SharedMemoryReader::SharedMemoryReader(SharedMemoryRing& ring, PacketDecoder& decoder)
+        : m_ring{ring}
+        , m_decoder{decoder}
+        , m_buffer(SharedMemorySink::s_chunkBytes)
+    {}
+
+    bool SharedMemoryReader::next()
+    {
+        while (true)
+        {
+            auto consumed = m_decoder.decode(m_buffer.data() + m_begin, m_end - m_begin);
+            m_begin += consumed;
+            if (consumed > 0 && m_decoder.done())
+                return true;  // decoding stops right after a stop packet
+
+            // Keep the incomplete packet and read more bytes after it
+            std::copy(m_buffer.begin() + m_begin, m_buffer.begin() + m_end, m_buffer.begin());
+            m_end -= m_begin;
+            m_begin = 0;
+
+            auto read = m_ring.read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+            if (read == 0)
+            {
+                if (m_end > 0)
+                    throw DecodeError("ring closed in the middle of a packet");
+                return false;
+            }
+            m_end += read;
+        }
+    }
+
+} // namespace Logi
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "PacketDecoder.hpp"
+#include "PacketGenerator.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Logi
+{
+    /// Single-producer single-consumer byte ring in POSIX shared memory, to pass
+    /// serialized packets between two processes.
+    ///
+    /// Reads and writes only touch the shared positions. A futex wakes the
+    /// other side up, and only when it is actually waiting, so no system call
+    /// is made while data flows.
+    class SharedMemoryRing
+    {
+    public:
+
+        /// Creates the shared memory object, which is removed when the creating
+        /// ring is destroyed.
+        ///
+        /// \param name The name of the shared memory object, e.g. "/packets".
+        /// \param capacity The number of bytes the ring holds.
+        /// \return The ring.
+        static SharedMemoryRing create(const std::string& name, size_t capacity);
+
+        /// Opens a ring created by another process.
+        ///
+        /// Throws std::runtime_error while the creator has not finished
+        /// initializing the ring, so that a process waiting for it can retry.
+        ///
+        /// \param name The name of the shared memory object.
+        /// \return The ring.
+        static SharedMemoryRing open(const std::string& name);
+
+        SharedMemoryRing(SharedMemoryRing&& other) noexcept;
+        SharedMemoryRing& operator=(SharedMemoryRing&& other) noexcept;
+        ~SharedMemoryRing();
+
+        SharedMemoryRing(const SharedMemoryRing&) = delete;
+        SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+        /// Writes all bytes, waiting for the reader to make room when the ring is full.
+        ///
+        /// \param data The bytes to be written.
+        /// \param size The number of bytes.
+        void write(const std::byte* data, size_t size);
+
+        /// Waits for free space at the write position, so that bytes can be
+        /// serialized into the ring in place.
+        ///
+        /// The space stops at the end of the ring. Otherwise it holds at least
+        /// minSize bytes.
+        ///
+        /// \param minSize The number of bytes wanted, at least 1.
+        /// \param size Set to the number of free bytes at the returned position.
+        /// \return The write position in the ring.
+        std::byte* reserve(size_t minSize, size_t& size);
+
+        /// Hands the first bytes of the reserved space over to the reader.
+        ///
+        /// \param size The number of bytes written since reserve().
+        void commit(size_t size);
+
+        /// Reads the available bytes, waiting for the writer when the ring is empty.
+        ///
+        /// \param out The destination.
+        /// \param size The maximum number of bytes to be read.
+        /// \return The number of bytes read, 0 once the writer closed the ring and all bytes were read.
+        size_t read(std::byte* out, size_t size);
+
+        /// Tells the reader that no more bytes will be written.
+        void close();
+
+        size_t capacity() const;
+
+    private:
+
+        struct Control;
+
+        SharedMemoryRing(void* address, size_t size, const std::string& name, bool owner);
+        Control& control() const;
+        std::byte* ring() const;
+        void unmap();
+
+        void* m_address{nullptr};
+        size_t m_size{0};
+        std::string m_name;
+        bool m_owner{false};
+    };
+
+    /// Serializes transfers into a shared memory ring.
+    ///
+    /// Packets are encoded straight from the input buffer into the ring, like
+    /// PacketGenerator::serialize() does. They are committed once per chunk of
+    /// s_chunkBytes, so that the reader is woken up per chunk rather than per
+    /// packet. Only a packet wrapping around the end of the ring goes through
+    /// a local copy.
+    class SharedMemorySink
+    {
+    public:
+
+        static constexpr size_t s_chunkBytes = 64 * 1024;
+
+        explicit SharedMemorySink(SharedMemoryRing& ring);
+
+        /// Serializes a transfer into the ring, segmented like PacketStream.
+        ///
+        /// \param generator The generator encoding the packets.
+        /// \param buffer The buffer containing data to be encoded.
+        /// \param size The size of the buffer.
+        /// \return The number of bytes written.
+        size_t write(PacketGenerator& generator, const std::byte* buffer, size_t size, const EndPacketFlags& flags);
+
+    private:
+
+        template<typename Serialize> void append(size_t packetSize, Serialize&& serialize);
+        void commit();
+
+        SharedMemoryRing& m_ring;
+        std::byte* m_out{nullptr};
+        size_t m_space{0};
+        size_t m_pending{0};
+    };
+
+    /// Reads the transfers serialized into a shared memory ring.
+    class SharedMemoryReader
+    {
+    public:
+
+        SharedMemoryReader(SharedMemoryRing& ring, PacketDecoder& decoder);
+
+        /// Decodes packets until the next transfer is complete, its payload
+        /// being then available from the decoder.
+        ///
+        /// \return Whether a transfer was completed, false once the writer closed the ring.
+        bool next();
+
+    private:
+
+        SharedMemoryRing& m_ring;
+        PacketDecoder& m_decoder;
+        std::vector<std::byte> m_buffer;
+        size_t m_begin{0};
+        size_t m_end{0};
+    };
+
+} // namespace Logi
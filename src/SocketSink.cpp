@@ -0,0 +1,113 @@
+#include "SocketSink.hpp"
+#include "PacketStream.hpp"
+#include "SystemError.hpp"
+#include "WireFormat.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace Logi
+{
+    SocketSink::SocketSink(int fd, size_t flushBytes, std::chrono::microseconds maxLatency)
+        : m_fd{fd}
+        , m_flushBytes{std::max<size_t>(flushBytes, 1)}
+        , m_maxLatency{maxLatency}
+        , m_buffer(m_flushBytes + maxPacketWireSize)
+    {
+        struct stat status;
+        if (::fstat(m_fd, &status) < 0)
+            throwSystemError("cannot inspect packets output");
+        m_isSocket = S_ISSOCK(status.st_mode);
+    }
+
+    SocketSink::~SocketSink()
+    {
+        try
+        {
+            flush();
+        }
+        catch (const std::system_error&)
+        {
+            // the reader is gone, the pending bytes cannot be delivered
+        }
+    }
+
+    size_t SocketSink::write(PacketGenerator& generator, const std::byte* buffer, size_t size, const EndPacketFlags& flags)
+    {
+        size_t written = 0;
+        PacketStream stream{generator, buffer, size, flags};
+        while (auto packet = stream.next())
+        {
+            written += append(*packet);
+        }
+        poll();
+        return written;
+    }
+
+    size_t SocketSink::write(const Packets& packets)
+    {
+        size_t written = 0;
+        for (const auto& packet : packets)
+        {
+            written += append(packet);
+        }
+        poll();
+        return written;
+    }
+
+    void SocketSink::poll()
+    {
+        if (m_size > 0 && std::chrono::steady_clock::now() - m_pendingSince >= m_maxLatency)
+            flush();
+    }
+
+    void SocketSink::flush()
+    {
+        writeAll(m_buffer.data(), m_size);
+        m_size = 0;
+    }
+
+    size_t SocketSink::writes() const
+    {
+        return m_writes;
+    }
+
+    size_t SocketSink::append(const PacketVariant& packet)
+    {
+        if (m_size == 0)
+            m_pendingSince = std::chrono::steady_clock::now();
+
+        auto begin = m_buffer.data() + m_size;
+        auto end = std::visit([&](const auto& packet) { return writePacket(begin, packet); }, packet);
+        auto packetSize = static_cast<size_t>(end - begin);
+        m_size += packetSize;
+
+        if (m_size >= m_flushBytes)
+            flush();
+        return packetSize;
+    }
+
+    void SocketSink::writeAll(const std::byte* data, size_t size)
+    {
+        if (size > 0)
+            m_writes++;
+
+        while (size > 0)
+        {
+            // A closed socket reports EPIPE instead of raising SIGPIPE
+            auto written = m_isSocket ? ::send(m_fd, data, size, MSG_NOSIGNAL) : ::write(m_fd, data, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throwSystemError("cannot write packets");
+            }
+            data += written;
+            size -= written;
+        }
+    }
+
+} // namespace Logi
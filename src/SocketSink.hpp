@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Packet.hpp"
+#include "PacketGenerator.hpp"
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace Logi
+{
+    /// Streams serialized packets over a Unix domain socket or a pipe, gathering
+    /// them into large writes.
+    ///
+    /// Pending bytes are written once they reach the flush threshold, or at the
+    /// end of a write() call when the oldest of them has waited for longer than
+    /// the latency cap. There is no timer: a producer going idle calls poll()
+    /// or flush() to bound the latency of what is still pending.
+    ///
+    /// Packets are only ever written whole, a packet being never split between
+    /// two flushes.
+    ///
+    /// A socket whose reader is gone reports EPIPE as a std::system_error. A
+    /// pipe whose reader is gone raises SIGPIPE instead, which terminates the
+    /// process unless the caller ignores or handles that signal.
+    class SocketSink
+    {
+    public:
+
+        static constexpr size_t s_defaultFlushBytes = 64 * 1024;
+        static constexpr std::chrono::microseconds s_defaultMaxLatency{1000};
+
+        /// Throws std::system_error if fd is not an open file descriptor.
+        ///
+        /// \param fd The connected socket or pipe, which is left open.
+        /// \param flushBytes The number of pending bytes triggering a write.
+        /// \param maxLatency How long bytes may stay pending.
+        explicit SocketSink(int fd, size_t flushBytes = s_defaultFlushBytes, std::chrono::microseconds maxLatency = s_defaultMaxLatency);
+
+        /// Writes the pending bytes.
+        ~SocketSink();
+
+        SocketSink(const SocketSink&) = delete;
+        SocketSink& operator=(const SocketSink&) = delete;
+
+        /// Serializes a transfer, segmented like PacketStream.
+        ///
+        /// \param generator The generator encoding the packets.
+        /// \param buffer The buffer containing data to be encoded.
+        /// \param size The size of the buffer.
+        /// \return The number of serialized bytes.
+        size_t write(PacketGenerator& generator, const std::byte* buffer, size_t size, const EndPacketFlags& flags);
+
+        /// Serializes the packets.
+        ///
+        /// \param packets The packets to be written.
+        /// \return The number of serialized bytes.
+        size_t write(const Packets& packets);
+
+        /// Writes the pending bytes if the oldest has waited for longer than the latency cap.
+        void poll();
+
+        /// Writes the pending bytes.
+        void flush();
+
+        /// Returns the number of writes made to the file descriptor.
+        size_t writes() const;
+
+    private:
+
+        size_t append(const PacketVariant& packet);
+        void writeAll(const std::byte* data, size_t size);
+
+        int m_fd{-1};
+        bool m_isSocket{false};
+        size_t m_flushBytes{0};
+        std::chrono::steady_clock::duration m_maxLatency{};
+        std::vector<std::byte> m_buffer;  // room for one packet past the flush threshold
+        size_t m_size{0};
+        std::chrono::steady_clock::time_point m_pendingSince;
+        size_t m_writes{0};
+    };
+
+} // namespace Logi
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+namespace Logi
+{
+    /// Closes the file descriptor when leaving the scope, a mapping of it stays valid.
+    class FileDescriptor
+    {
+    public:
+        explicit FileDescriptor(int fd) : m_fd{fd} {}
+        ~FileDescriptor() { if (m_fd >= 0) ::close(m_fd); }
+
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+        int get() const { return m_fd; }
+
+    private:
+        int m_fd;
+    };
+
+    /// Throws std::system_error for the current errno.
+    [[noreturn]] inline void throwSystemError(const std::string& what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+} // namespace Logi
@@ -1,29 +1,89 @@
 #include "Utils.hpp"
-#include <cstdlib>
-#include <ctime>
+#include <random>
 
 namespace Logi
 {
+    namespace{
+        constexpr uint64_t s_goldenGamma = 0x9E3779B97F4A7C15;
+
+        // SplitMix64 output function, a bijective 64-bit mixer
+        uint64_t mix64(uint64_t z)
+        {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+            return z ^ (z >> 31);
+        }
+
+        // Each 64-bit block of the stream only depends on the seed and its
+        // index, so the loop has no dependency between iterations.
+        uint64_t randomBlock(uint64_t seed, uint64_t index)
+        {
+            return mix64(seed + (index + 1) * s_goldenGamma);
+        }
+    }
+
+    uint64_t generateSeed()
+    {
+        std::random_device device;
+        return (uint64_t{device()} << 32) | device();
+    }
 
     std::vector<std::byte> generateRandomBuffer(uint64_t size)
     {
-        std::vector<std::byte> buffer;
-        buffer.resize(size);
-        srand((unsigned) time(0));
-        for(auto& byte : buffer)
+        return generateRandomBuffer(size, generateSeed());
+    }
+
+    std::vector<std::byte> generateRandomBuffer(uint64_t size, uint64_t seed)
+    {
+        return generateRandomBuffer(size, seed, 0);
+    }
+
+    std::vector<std::byte> generateRandomBuffer(uint64_t size, uint64_t seed, uint64_t offset)
+    {
+        std::vector<std::byte> buffer(size);
+        fillRandomBuffer(buffer.data(), size, seed, offset);
+        return buffer;
+    }
+
+    void fillRandomBuffer(std::byte* out, uint64_t size, uint64_t seed, uint64_t offset)
+    {
+        auto end = offset + size;
+        auto position = offset;
+
+        // Leading bytes up to the first block boundary
+        while (position < end && position % 8 != 0)
         {
-            byte = static_cast<std::byte>(rand() % 256);
+            *out++ = static_cast<std::byte>(randomBlock(seed, position / 8) >> (8 * (position % 8)));
+            position++;
+        }
+
+        for (; position + 8 <= end; position += 8, out += 8)
+        {
+            auto value = randomBlock(seed, position / 8);
+            for (int i = 0; i < 8; i++)
+            {
+                out[i] = static_cast<std::byte>(value >> (8 * i));  // little endian on every host
+            }
+        }
+
+        // Trailing bytes of the last partial block
+        for (; position < end; position++)
+        {
+            *out++ = static_cast<std::byte>(randomBlock(seed, position / 8) >> (8 * (position % 8)));
         }
-        return buffer;
     }
 
     std::vector<bool> generateRandomFlags(uint16_t size)
+    {
+        return generateRandomFlags(size, generateSeed());
+    }
+
+    std::vector<bool> generateRandomFlags(uint16_t size, uint64_t seed)
     {
         std::vector<bool> flags;
-        srand((unsigned) time(0));
         for (size_t i = 0; i < size; i++)
         {
-            flags.emplace_back(rand() % 2);
+            flags.emplace_back(randomBlock(seed, i) & 1);
         }
         return flags;
     }
@@ -60,7 +120,7 @@ namespace Logi
 
     uint32_t readField32(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3, bool swap)
     {
-        uint16_t x = b0 | (b1 << 8) | (b2 << 16) | (b3 << 24);
+        uint32_t x = b0 | (b1 << 8) | (b2 << 16) | (uint32_t{b3} << 24);
         if (swap)
             x = byteSwap32(x);
         return x; 
@@ -12,8 +12,22 @@ namespace Logi
         LittleEndian = false
     };
 
+    /// Returns a seed from the system entropy source.
+    uint64_t generateSeed();
+
+    /// Generates random bytes with a counter-based generator (SplitMix64),
+    /// 8 bytes per step. The same seed always produces the same buffer.
     std::vector<std::byte> generateRandomBuffer(uint64_t size);
+    std::vector<std::byte> generateRandomBuffer(uint64_t size, uint64_t seed);
+
+    /// Generates the bytes [offset, offset + size) of the random stream of seed.
+    ///
+    /// Any range can be generated independently, e.g. by several threads
+    /// filling disjoint slices of one buffer, or to regenerate a single slice.
+    std::vector<std::byte> generateRandomBuffer(uint64_t size, uint64_t seed, uint64_t offset);
+    void fillRandomBuffer(std::byte* out, uint64_t size, uint64_t seed, uint64_t offset);
     std::vector<bool> generateRandomFlags(uint16_t size);
+    std::vector<bool> generateRandomFlags(uint16_t size, uint64_t seed);
 
     Endianess checkHostEndianess();
 
@@ -0,0 +1,60 @@
+#include "WireFormat.hpp"
+#include <cstring>
+
+namespace Logi
+{
+    std::byte* writeHeader(std::byte* out, const PacketHeader& header)
+    {
+        out[0] = static_cast<std::byte>(header.softwareId);
+        out[1] = static_cast<std::byte>(header.sequenceId_0);
+        out[2] = static_cast<std::byte>(header.sequenceId_1);
+        out[3] = static_cast<std::byte>(header.packetType);
+        return out + headerWireSize;
+    }
+
+    PacketHeader readHeader(const std::byte* in)
+    {
+        PacketHeader header;
+        header.softwareId = static_cast<uint8_t>(in[0]);
+        header.sequenceId_0 = static_cast<uint8_t>(in[1]);
+        header.sequenceId_1 = static_cast<uint8_t>(in[2]);
+        header.packetType = static_cast<uint8_t>(in[3]);
+        return header;
+    }
+
+    std::byte* writeDataPacket(std::byte* out, const PacketHeader& header, uint8_t payloadSize, const std::byte* payload)
+    {
+        out = writeHeader(out, header);
+        *out++ = static_cast<std::byte>(payloadSize);
+        std::memcpy(out, payload, payloadSize);
+        return out + payloadSize;
+    }
+
+    std::byte* writePacket(std::byte* out, const StartDataTransferPacket& packet)
+    {
+        out = writeHeader(out, packet.header);
+        out[0] = static_cast<std::byte>(packet.totalPayloadSize_0);
+        out[1] = static_cast<std::byte>(packet.totalPayloadSize_1);
+        out[2] = static_cast<std::byte>(packet.totalPayloadSize_2);
+        out[3] = static_cast<std::byte>(packet.totalPayloadSize_3);
+        return out + 4;
+    }
+
+    std::byte* writePacket(std::byte* out, const DataPacket& packet)
+    {
+        return writeDataPacket(out, packet.header, packet.payloadSize, packet.data.data());
+    }
+
+    std::byte* writePacket(std::byte* out, const DataPacketView& packet)
+    {
+        return writeDataPacket(out, packet.header, packet.payloadSize, packet.data);
+    }
+
+    std::byte* writePacket(std::byte* out, const StopDataTransferPacket& packet)
+    {
+        out = writeHeader(out, packet.header);
+        *out++ = static_cast<std::byte>(packet.flags);
+        return out;
+    }
+
+} // namespace Logi
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Packet.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace Logi
+{
+    /// Number of bytes each packet occupies once encoded on the wire.
+    constexpr size_t headerWireSize         = 4;
+    constexpr size_t startPacketWireSize    = headerWireSize + 4;
+    constexpr size_t dataPacketWireOverhead = headerWireSize + 1;
+    constexpr size_t stopPacketWireSize     = headerWireSize + 1;
+
+    /// Size of the largest packet, a data packet with a full payload.
+    constexpr size_t maxPacketWireSize      = dataPacketWireOverhead + maxPayloadSize;
+
+    /// Writes the packet header in its on-wire layout.
+    ///
+    /// \param out The destination, must have room for headerWireSize bytes.
+    /// \param header The header to be written.
+    /// \return Pointer past the last written byte.
+    std::byte* writeHeader(std::byte* out, const PacketHeader& header);
+
+    /// Writes a data packet in its on-wire layout.
+    ///
+    /// \param out The destination, must have room for dataPacketWireOverhead + payloadSize bytes.
+    /// \param header The header of the data packet.
+    /// \param payloadSize The number of payload bytes.
+    /// \param payload The payload bytes.
+    /// \return Pointer past the last written byte.
+    std::byte* writeDataPacket(std::byte* out, const PacketHeader& header, uint8_t payloadSize, const std::byte* payload);
+
+    /// Reads a packet header from its on-wire layout.
+    ///
+    /// \param in The source, must hold at least headerWireSize bytes.
+    /// \return The header.
+    PacketHeader readHeader(const std::byte* in);
+
+    std::byte* writePacket(std::byte* out, const StartDataTransferPacket& packet);
+    std::byte* writePacket(std::byte* out, const DataPacket& packet);
+    std::byte* writePacket(std::byte* out, const DataPacketView& packet);
+    std::byte* writePacket(std::byte* out, const StopDataTransferPacket& packet);
+
+} // namespace Logi
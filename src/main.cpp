@@ -1,15 +1,133 @@
+#include "CommandLine.hpp"
 #include "ConsolePrinter.hpp"
+#include "FilePrinter.hpp"
 #include "IPrinter.hpp"
+#include "MappedFile.hpp"
+#include "NullPrinter.hpp"
 #include "PacketGenerator.hpp"
+#include "PacketStream.hpp"
 #include "Utils.hpp"
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
 #include <cstddef>
 #include <limits>
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 
-int main() {
+namespace{
+    constexpr size_t s_packetsPerPrint = 4096;
+
+    std::unique_ptr<Logi::IPrinter> createPrinter(const std::string& output)
+    {
+        if (output == "null")
+            return std::make_unique<Logi::NullPrinter>();
+        if (output.rfind("file:", 0) == 0)
+            return std::make_unique<Logi::FilePrinter>(output.substr(5));
+        return std::make_unique<Logi::ConsolePrinter>();
+    }
+
+    /// Generates the packets of one input and prints them in chunks, without
+    /// materializing the whole transfer. Inputs larger than maxSegmentBytes are
+    /// split into several transfers.
+    ///
+    /// \return The number of generated packets.
+    size_t packetize(Logi::PacketGenerator& packetGenerator, const std::byte* buffer, size_t size, const Logi::EndPacketFlags& flags,
+        size_t maxSegmentBytes, bool print)
+    {
+        Logi::PacketStream stream{packetGenerator, buffer, size, flags, maxSegmentBytes};
+
+        size_t count = 0;
+        Logi::Packets packets;
+        packets.reserve(print ? s_packetsPerPrint : 0);
+        while (auto packet = stream.next())
+        {
+            count++;
+            if (!print)
+                continue;
+
+            packets.emplace_back(*packet);
+            if (packets.size() == s_packetsPerPrint)
+            {
+                packetGenerator.printPackets(packets);
+                packets.clear();
+            }
+        }
+
+        if (!packets.empty())
+            packetGenerator.printPackets(packets);
+
+        return count;
+    }
+
+    /// Runs the non-interactive mode described by the command line options.
+    void runBatch(const Logi::CommandLineOptions& options)
+    {
+        std::optional<Logi::ReadOnlyMappedFile> firmware;
+        std::vector<std::byte> randomBuffer;
+        if (!options.inputPath.empty())
+            firmware.emplace(Logi::ReadOnlyMappedFile::open(options.inputPath));
+        else if (options.seed)
+            randomBuffer = Logi::generateRandomBuffer(options.size, *options.seed);
+        else
+            randomBuffer = Logi::generateRandomBuffer(options.size);
+
+        const std::byte* buffer = firmware ? firmware->data() : randomBuffer.data();
+        size_t size = firmware ? firmware->size() : randomBuffer.size();
+
+        auto maxSegmentBytes = options.segmentSize.value_or(Logi::PacketGenerator::s_maxTransferBytes);
+
+        size_t packets = 0;
+        auto start = std::chrono::steady_clock::now();
+        {
+            auto printer = createPrinter(options.output);
+            Logi::PacketGenerator packetGenerator{options.softwareId, options.endianess, *printer};
+            for (unsigned int i = 0; i < options.repeat; i++)
+            {
+                packets += packetize(packetGenerator, buffer, size, options.flags, maxSegmentBytes, !options.quiet);
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (options.stats)
+        {
+            auto bytes = static_cast<double>(size) * options.repeat;
+            std::cout << "repetitions: " << options.repeat << "\n"
+                      << "packets: " << packets << "\n"
+                      << "payload bytes: " << static_cast<uint64_t>(bytes) << "\n"
+                      << "seconds: " << elapsed.count() << "\n"
+                      << "packets/s: " << packets / elapsed.count() << "\n"
+                      << "MB/s: " << bytes / (1024 * 1024) / elapsed.count() << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc > 1)
+    {
+        try
+        {
+            auto options = Logi::parseCommandLine(argc, argv);
+            if (options.help)
+                std::cout << Logi::commandLineUsage();
+            else
+                runBatch(options);
+            return 0;
+        }
+        catch (const std::invalid_argument& e)
+        {
+            std::cerr << e.what() << "\n\n" << Logi::commandLineUsage();
+            return 1;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
 
     uint8_t softwareId{69};
     unsigned int bufferSize{};
@@ -0,0 +1,66 @@
+#include "../src/CommandLine.hpp"
+
+#include "catch.hpp"
+
+#include <stdexcept>
+
+using namespace Logi;
+
+TEST_CASE("Parse batch mode command line")
+{
+    const char* argv[] = {
+        "packet_generator", "--size", "4096", "--seed", "42", "--software-id", "0x34",
+        "--endianess", "big", "--flags", "test,reboot", "--repeat", "10", "--segment-size", "3866506",
+        "--output", "file:dump.txt", "--quiet", "--stats", "firmware.bin"
+    };
+    auto options = parseCommandLine(sizeof(argv) / sizeof(argv[0]), argv);
+
+    CHECK(options.size == 4096);
+    REQUIRE(options.seed.has_value());
+    CHECK(*options.seed == 42);
+    CHECK(options.softwareId == 0x34);
+    CHECK(options.endianess == Endianess::BigEndian);
+    CHECK(options.flags.test);
+    CHECK_FALSE(options.flags.verify);
+    CHECK(options.flags.reboot);
+    CHECK(options.repeat == 10);
+    CHECK(options.segmentSize == 3866506u);
+    CHECK(options.output == "file:dump.txt");
+    CHECK(options.quiet);
+    CHECK(options.stats);
+    CHECK(options.inputPath == "firmware.bin");
+    CHECK_FALSE(options.help);
+}
+
+TEST_CASE("Command line defaults")
+{
+    const char* argv[] = {"packet_generator", "--stats"};
+    auto options = parseCommandLine(2, argv);
+
+    CHECK(options.size == 1000);
+    CHECK_FALSE(options.seed.has_value());
+    CHECK(options.softwareId == 69);
+    CHECK(options.endianess == Endianess::LittleEndian);
+    CHECK(options.repeat == 1);
+    CHECK(options.output == "console");
+    CHECK_FALSE(options.quiet);
+    CHECK(options.inputPath.empty());
+}
+
+TEST_CASE("Reject invalid command lines")
+{
+    auto parse = [](std::initializer_list<const char*> args) {
+        std::vector<const char*> argv{"packet_generator"};
+        argv.insert(argv.end(), args);
+        return parseCommandLine(static_cast<int>(argv.size()), argv.data());
+    };
+
+    CHECK_THROWS_AS(parse({"--unknown"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"--size"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"--size", "12abc"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"--software-id", "256"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"--endianess", "middle"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"--flags", "test,format"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"--output", "printer"}), std::invalid_argument);
+    CHECK_THROWS_AS(parse({"a.bin", "b.bin"}), std::invalid_argument);
+}
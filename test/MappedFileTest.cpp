@@ -0,0 +1,65 @@
+#include "../src/MappedFile.hpp"
+#include "../src/NullPrinter.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/Utils.hpp"
+#include "TemporaryPath.hpp"
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+using namespace Logi;
+
+TEST_CASE("Serialize transfer into a memory-mapped file")
+{
+    NullPrinter printer;
+    PacketGenerator generator{52, printer};
+    PacketGenerator reference{52, printer};
+
+    auto buffer = generateRandomBuffer(5000);
+    TemporaryPath path{"MappedFileTest.bin"};
+
+    auto written = serializeToMappedFile(generator, path.str(), buffer.data(), buffer.size(), {false, false, true});
+    CHECK(written == PacketGenerator::serializedSize(buffer.size()));
+
+    std::ifstream file{path.str(), std::ios::binary};
+    std::vector<char> content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    auto expected = reference.serialize(buffer, {false, false, true});
+    REQUIRE(content.size() == expected.size());
+    CHECK(std::memcmp(content.data(), expected.data(), expected.size()) == 0);
+
+    {
+        auto mapped = ReadOnlyMappedFile::open(path.str());
+        static_assert(std::is_same_v<decltype(mapped.data()), const std::byte*>, "read-only mappings cannot be written");
+        REQUIRE(mapped.size() == expected.size());
+        CHECK(std::memcmp(mapped.data(), expected.data(), expected.size()) == 0);
+    }
+    std::remove(path.str().c_str());
+    CHECK_THROWS_AS(ReadOnlyMappedFile::open(path.str()), std::system_error);
+}
+
+TEST_CASE("Oversized transfers leave the existing file untouched")
+{
+    NullPrinter printer;
+    PacketGenerator generator{52, printer};
+    TemporaryPath path{"MappedFileOversizedTest.bin"};
+    {
+        std::ofstream file{path.str(), std::ios::binary};
+        file << "previous content";
+    }
+
+    auto buffer = generateRandomBuffer(16);
+    size_t tooLarge = PacketGenerator::s_maxTransferBytes + 1;
+    CHECK_THROWS_AS(serializeToMappedFile(generator, path.str(), buffer.data(), tooLarge, {}), std::length_error);
+
+    std::ifstream file{path.str(), std::ios::binary};
+    CHECK(std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}} == "previous content");
+}
@@ -0,0 +1,82 @@
+#include "../src/PacketCoroutine.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/Utils.hpp"
+#include "../src/IPrinter.hpp"
+
+#include "catch.hpp"
+#include "trompeloeil.hpp"
+
+#include <vector>
+
+using namespace Logi;
+
+namespace{
+    class PrinterMock : public trompeloeil::mock_interface<IPrinter>
+    {
+        IMPLEMENT_MOCK1(print);
+    };
+
+    std::vector<std::byte> collectPayload(const Packets& packets)
+    {
+        std::vector<std::byte> payload;
+        for (const auto& packet : packets)
+        {
+            if (auto data = std::get_if<DataPacket>(&packet))
+                payload.insert(payload.end(), data->data.begin(), data->data.begin() + data->payloadSize);
+        }
+        return payload;
+    }
+}
+
+TEST_CASE("Coroutine yields the packets of a transfer")
+{
+    PrinterMock printer;
+    PacketGenerator generator{52, printer};
+    PacketGenerator reference{52, printer};
+
+    auto buffer = generateRandomBuffer(1000);
+    auto expected = reference.createPackets(buffer, {true, true, false});
+
+    Packets packets;
+    for (const auto& packet : generatePackets(generator, buffer.data(), buffer.size(), {true, true, false}))
+    {
+        packets.emplace_back(packet);
+    }
+
+    REQUIRE(packets.size() == expected.size());
+    CHECK(collectPayload(packets) == buffer);
+    CHECK(std::get<StopDataTransferPacket>(packets.back()).header.sequenceId_0 == 0x12);
+    CHECK(std::get<StopDataTransferPacket>(packets.back()).flags == 0b00000110);
+}
+
+TEST_CASE("Coroutine transfers can be interleaved")
+{
+    PrinterMock printer;
+    PacketGenerator generatorA{1, printer};
+    PacketGenerator generatorB{2, printer};
+
+    auto bufferA = generateRandomBuffer(500);
+    auto bufferB = generateRandomBuffer(120);
+
+    auto transferA = generatePackets(generatorA, bufferA.data(), bufferA.size(), {});
+    auto transferB = generatePackets(generatorB, bufferB.data(), bufferB.size(), {});
+
+    Packets packetsA;
+    Packets packetsB;
+    bool activeA = true;
+    bool activeB = true;
+    while (activeA || activeB)
+    {
+        if (activeA && (activeA = transferA.next()))
+            packetsA.emplace_back(transferA.value());
+        if (activeB && (activeB = transferB.next()))
+            packetsB.emplace_back(transferB.value());
+    }
+
+    REQUIRE(packetsA.size() == 11);
+    REQUIRE(packetsB.size() == 5);
+    CHECK(collectPayload(packetsA) == bufferA);
+    CHECK(collectPayload(packetsB) == bufferB);
+    CHECK(std::get<StopDataTransferPacket>(packetsB.back()).header.softwareId == 2);
+    CHECK_FALSE(transferA.next());
+}
@@ -0,0 +1,159 @@
+#include "../src/NullPrinter.hpp"
+#include "../src/PacketDecoder.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/Utils.hpp"
+#include "../src/WireFormat.hpp"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Logi;
+
+TEST_CASE("Decode serialized transfers")
+{
+    NullPrinter printer;
+    auto endianess = GENERATE(Endianess::LittleEndian, Endianess::BigEndian);
+    auto size = GENERATE(0, 1, 59, 60, 10000);
+
+    PacketGenerator generator{77, endianess, printer};
+    PacketDecoder decoder{77, endianess};
+
+    auto buffer = generateRandomBuffer(size, 3);
+    auto serialized = generator.serialize(buffer, {true, false, true});
+
+    CHECK(decoder.decode(serialized.data(), serialized.size()) == serialized.size());
+    REQUIRE(decoder.done());
+    CHECK(decoder.payload() == buffer);
+    CHECK(decoder.flags().reboot);
+    CHECK_FALSE(decoder.flags().verify);
+    CHECK(decoder.flags().test);
+}
+
+TEST_CASE("Decode packets")
+{
+    NullPrinter printer;
+    PacketGenerator generator{5, printer};
+    PacketDecoder decoder{5};
+
+    // Sequence ids continue across transfers and wrap around after 0xFFFF
+    auto buffer = generateRandomBuffer(0x10000 * maxPayloadSize / 3, 8);
+    for (int transfer = 0; transfer < 4; transfer++)
+    {
+        decoder.decode(generator.createPackets(buffer, {}));
+        REQUIRE(decoder.done());
+        CHECK(decoder.payload() == buffer);
+    }
+}
+
+TEST_CASE("Decode serialized packets split at any byte")
+{
+    NullPrinter printer;
+    PacketGenerator generator{9, printer};
+    PacketDecoder decoder{9};
+
+    auto buffer = generateRandomBuffer(250, 4);
+    std::vector<std::byte> serialized;
+    for (int transfer = 0; transfer < 2; transfer++)
+    {
+        auto packets = generator.serialize(buffer, {});
+        serialized.insert(serialized.end(), packets.begin(), packets.end());
+    }
+
+    // Bytes arrive in chunks of 7, incomplete packets are left for the next call
+    std::vector<std::byte> pending;
+    int transfers = 0;
+    for (size_t offset = 0; offset < serialized.size(); offset += 7)
+    {
+        auto end = serialized.begin() + std::min(offset + 7, serialized.size());
+        pending.insert(pending.end(), serialized.begin() + offset, end);
+
+        size_t consumed;
+        while ((consumed = decoder.decode(pending.data(), pending.size())) > 0)
+        {
+            pending.erase(pending.begin(), pending.begin() + consumed);
+            if (decoder.done())
+            {
+                CHECK(decoder.payload() == buffer);
+                transfers++;
+            }
+        }
+    }
+    CHECK(transfers == 2);
+    CHECK(pending.empty());
+}
+
+TEST_CASE("Reject invalid packet streams")
+{
+    NullPrinter printer;
+    PacketGenerator generator{1, printer};
+    auto buffer = generateRandomBuffer(200, 5);
+    auto packets = generator.createPackets(buffer, {});
+
+    SECTION("Unexpected software id")
+    {
+        PacketDecoder decoder{2};
+        CHECK_THROWS_AS(decoder.decode(packets), DecodeError);
+    }
+
+    SECTION("Missing data packet")
+    {
+        PacketDecoder decoder{1};
+        packets.erase(packets.begin() + 2);
+        CHECK_THROWS_AS(decoder.decode(packets), DecodeError);
+    }
+
+    SECTION("Data packet before the start packet")
+    {
+        PacketDecoder decoder{1};
+        CHECK_THROWS_AS(decoder.decode(packets.at(1)), DecodeError);
+    }
+
+    SECTION("Stop packet before all data")
+    {
+        auto truncated = generator.createPackets(buffer, {});
+        truncated.erase(truncated.end() - 2);
+        auto& stop = std::get<StopDataTransferPacket>(truncated.back()).header;
+        stop.sequenceId_0--;
+
+        PacketDecoder decoder{1};
+        CHECK_THROWS_AS(decoder.decode(truncated), DecodeError);
+    }
+
+    SECTION("Invalid payload size")
+    {
+        auto serialized = generator.serialize(buffer, {});
+        serialized.at(startPacketWireSize + headerWireSize) = std::byte{60};
+
+        PacketDecoder decoder{1};
+        CHECK_THROWS_AS(decoder.decode(serialized.data(), serialized.size()), DecodeError);
+    }
+
+    SECTION("Total payload size above the maximum")
+    {
+        auto serialized = generator.serialize(buffer, {});
+        PacketDecoder decoder{1, Endianess::LittleEndian, 100};
+        CHECK_THROWS_AS(decoder.decode(serialized.data(), serialized.size()), DecodeError);
+        CHECK(decoder.payload().capacity() == 0);
+    }
+
+    SECTION("Corrupt total payload size")
+    {
+        // The declared 4 GiB are rejected before anything is allocated
+        auto serialized = generator.serialize(buffer, {});
+        std::fill_n(serialized.begin() + headerWireSize, 4, std::byte{0xFF});
+
+        PacketDecoder decoder{1};
+        CHECK_THROWS_AS(decoder.decode(serialized.data(), startPacketWireSize), DecodeError);
+        CHECK(decoder.payload().capacity() == 0);
+    }
+
+    SECTION("Unknown packet type")
+    {
+        std::vector<std::byte> serialized{std::byte{1}, std::byte{0}, std::byte{0}, std::byte{7}};
+
+        PacketDecoder decoder{1};
+        CHECK_THROWS_AS(decoder.decode(serialized.data(), serialized.size()), DecodeError);
+    }
+}
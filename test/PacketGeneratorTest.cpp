@@ -1,14 +1,22 @@
+#include "../src/AllocationCounter.hpp"
+#include "../src/PacketEncoder.hpp"
 #include "../src/PacketGenerator.hpp"
+#include "../src/PacketStream.hpp"
 #include "../src/Packet.hpp"
 #include "../src/Utils.hpp"
 #include "../src/IPrinter.hpp"
+#include "../src/WireFormat.hpp"
 
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "trompeloeil.hpp"
 
+#include <cstdio>
+#include <optional>
+#include <utility>
 #include <vector>
 #include <string_view>
+#include <thread>
 
 using namespace Logi;
 
@@ -53,6 +61,14 @@ namespace{
     class PrinterMock : public trompeloeil::mock_interface<IPrinter>
     {
         IMPLEMENT_MOCK1(print);
+        IMPLEMENT_MOCK1(printBatch);
+    };
+
+    class LinePrinter : public IPrinter
+    {
+    public:
+        void print(std::string_view str) override { lines.emplace_back(str); }
+        std::vector<std::string> lines;
     };
 
     class TestFixture
@@ -99,7 +115,6 @@ TEST_CASE_METHOD(TestFixture, "Create packets for 1-byte buffer")
     CHECK(packet1.header.sequenceId_1 == 0x00);
     CHECK(packet1.header.packetType == static_cast<uint8_t>(PacketType::Data));
     CHECK(packet1.payloadSize == 0x01);
-    CHECK(packet1.data.size() == 1);
     CHECK(packet1.data.at(0) == buffer.at(0));
 
     // Check StopDataTransferPacket
@@ -151,8 +166,7 @@ TEST_CASE_METHOD(TestFixture, "Create packets for 1K-byte buffer")
         CHECK(packetData.header.sequenceId_1 == 0x00);
         CHECK(packetData.header.packetType == static_cast<uint8_t>(PacketType::Data));
         CHECK(packetData.payloadSize == 59);
-        CHECK(packetData.data.size() == 59);
-        returnedPayload.insert(returnedPayload.end(), packetData.data.begin(), packetData.data.end());
+        returnedPayload.insert(returnedPayload.end(), packetData.data.begin(), packetData.data.begin() + packetData.payloadSize);
     }    
 
     // Check last DataPacket
@@ -163,8 +177,7 @@ TEST_CASE_METHOD(TestFixture, "Create packets for 1K-byte buffer")
     CHECK(packetData.header.sequenceId_1 == 0x00);
     CHECK(packetData.header.packetType == static_cast<uint8_t>(PacketType::Data));
     CHECK(packetData.payloadSize == 56);
-    CHECK(packetData.data.size() == 56);
-    returnedPayload.insert(returnedPayload.end(), packetData.data.begin(), packetData.data.end());
+    returnedPayload.insert(returnedPayload.end(), packetData.data.begin(), packetData.data.begin() + packetData.payloadSize);
 
     CHECK (returnedPayload == buffer);
 
@@ -259,14 +272,424 @@ TEST_CASE_METHOD(TestFixture, "Reset sequenceId to 0x0000 after 0xffff")
     CHECK(+packet2.header.sequenceId_1 == 0x00);
 }
 
+TEST_CASE("Create packets in parallel")
+{
+    PrinterMock printer;
+    PacketGenerator generator{52, printer};
+    PacketGenerator reference{52, printer};
+
+    // Large enough to cross the 0xFFFF sequence id wraparound
+    auto buffer = generateRandomBuffer(4000000);
+    auto packets = generator.createPackets(buffer.data(), buffer.size(), {true, false, false}, 4);
+    auto expected = reference.createPackets(buffer, {true, false, false});
+
+    REQUIRE(packets.size() == expected.size());
+    REQUIRE(packets.size() == 67799);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+        REQUIRE(packets.at(i).index() == expected.at(i).index());
+        std::visit([&](const auto& packet) {
+            using T = std::decay_t<decltype(packet)>;
+            const auto& other = std::get<T>(expected.at(i));
+            mismatches += std::memcmp(&packet, &other, sizeof(T)) != 0;
+        }, packets.at(i));
+    }
+    CHECK(mismatches == 0);
+
+    // The sequence id continues after the parallel transfer
+    auto next = generator.createPackets(buffer.data(), 1, {}, 4);
+    auto nextExpected = reference.createPackets(buffer.data(), 1, {});
+    CHECK(std::get<StartDataTransferPacket>(next.at(0)).header.sequenceId_0 == std::get<StartDataTransferPacket>(nextExpected.at(0)).header.sequenceId_0);
+    CHECK(std::get<StartDataTransferPacket>(next.at(0)).header.sequenceId_1 == std::get<StartDataTransferPacket>(nextExpected.at(0)).header.sequenceId_1);
+}
+
+TEST_CASE_METHOD(TestFixture, "Count allocations per transfer")
+{
+    auto buffer = generateRandomBuffer(1000);
+    std::vector<std::byte> out(PacketGenerator::serializedSize(buffer.size()));
+
+    // The packets vector is the only allocation of createPackets
+    AllocationScope createScope;
+    auto packets = generator.createPackets(buffer, {});
+    CHECK(createScope.stats().allocations == 1);
+    CHECK(createScope.stats().bytes == packets.capacity() * sizeof(PacketVariant));
+
+    AllocationScope serializeScope;
+    generator.serialize(buffer.data(), buffer.size(), {}, out.data(), out.size());
+    CHECK(serializeScope.stats().allocations == 0);
+}
+
+TEST_CASE_METHOD(TestFixture, "Allocate packets from a memory resource")
+{
+    auto buffer = generateRandomBuffer(1000);
+    auto expected = PacketGenerator{52, printer}.createPackets(buffer, {});
+
+    std::vector<std::byte> arena(4096);
+    std::pmr::monotonic_buffer_resource resource{arena.data(), arena.size(), std::pmr::null_memory_resource()};
+
+    AllocationScope scope;
+    auto packets = generator.createPackets(buffer.data(), buffer.size(), {}, &resource);
+    CHECK(scope.stats().allocations == 0);
+
+    REQUIRE(packets.size() == expected.size());
+    CHECK(packets.get_allocator().resource() == &resource);
+    CHECK(reinterpret_cast<const std::byte*>(packets.data()) >= arena.data());
+    CHECK(reinterpret_cast<const std::byte*>(packets.data() + packets.size()) <= arena.data() + arena.size());
+    for (size_t i = 1; i < packets.size() - 1; i++)
+    {
+        CHECK(std::memcmp(&std::get<DataPacket>(packets.at(i)), &std::get<DataPacket>(expected.at(i)), sizeof(DataPacket)) == 0);
+    }
+
+    REQUIRE_CALL(printer, printBatch(ANY(const PrintBatch&))).TIMES(1);
+    generator.printPackets(packets);
+}
+
 TEST_CASE_METHOD(TestFixture, "Print packets")
 {
     trompeloeil::sequence seq;
     auto buffer = generateRandomBuffer(10);
     auto packets = generator.createPackets(buffer, {false, true, false});
     CHECK(packets.size() == 3);
-    REQUIRE_CALL(printer, print(ANY(std::string_view))).TIMES(3);
+    REQUIRE_CALL(printer, printBatch(ANY(const PrintBatch&))).TIMES(1);
+    generator.printPackets(packets);
+}
+
+TEST_CASE_METHOD(TestFixture, "Print packets text")
+{
+    auto buffer = generateRandomBuffer(300);
+    auto packets = generator.createPackets(buffer, {false, true, false});
+    REQUIRE(packets.size() == 8);
+
+    std::vector<std::string> records;
+    std::string text;
+    REQUIRE_CALL(printer, printBatch(ANY(const PrintBatch&)))
+        .LR_SIDE_EFFECT(records.assign(_1.records.begin(), _1.records.end()); text = _1.text);
+    generator.printPackets(Packets{packets.at(0), packets.at(6), packets.at(7)});
+
+    REQUIRE(records.size() == 3);
+    CHECK(records.at(0) ==
+        "software id: 0x34\n"
+        "sequence id: 0x0000\n"
+        "packet type: StartDataTransfer\n"
+        "total payload size: 300\n");
+    CHECK(records.at(1) ==
+        "software id: 0x34\n"
+        "sequence id: 0x0006\n"
+        "packet type: Data\n"
+        "payload size: 5\n");
+    CHECK(records.at(2) ==
+        "software id: 0x34\n"
+        "sequence id: 0x0007\n"
+        "packet type: StopDataTransfer\n"
+        "test: false\n"
+        "verify: true\n"
+        "reboot: false\n");
+
+    // The text holds the records, each followed by a newline
+    CHECK(text == records.at(0) + "\n" + records.at(1) + "\n" + records.at(2) + "\n");
+}
+
+TEST_CASE_METHOD(TestFixture, "Print large transfers in batches")
+{
+    auto buffer = generateRandomBuffer(100000);
+    auto packets = generator.createPackets(buffer, {});
+
+    size_t printed = 0;
+    size_t calls = 0;
+    ALLOW_CALL(printer, printBatch(ANY(const PrintBatch&))).LR_SIDE_EFFECT(printed += _1.records.size(); calls++);
     generator.printPackets(packets);
+
+    CHECK(calls > 1);
+    CHECK(calls < packets.size());
+    CHECK(printed == packets.size());
+}
+
+TEST_CASE("Single-line printers get one print per packet")
+{
+    LinePrinter printer;
+    PacketGenerator generator{52, printer};
+
+    auto buffer = generateRandomBuffer(10);
+    generator.printPackets(generator.createPackets(buffer, {}));
+
+    REQUIRE(printer.lines.size() == 3);
+    CHECK(printer.lines.at(1).find("packet type: Data\n") != std::string::npos);
+}
+
+TEST_CASE_METHOD(TestFixture, "Data packets are trivially copyable")
+{
+    auto buffer = generateRandomBuffer(100);
+    auto packets = generator.createPackets(buffer, {});
+    REQUIRE(packets.size() == 4);
+
+    DataPacket copy;
+    std::memcpy(&copy, &std::get<DataPacket>(packets.at(2)), sizeof(DataPacket));
+    CHECK(copy.payloadSize == 41);
+    CHECK(std::equal(copy.data.begin(), copy.data.begin() + copy.payloadSize, buffer.begin() + 59));
+}
+
+TEST_CASE("Create packet views referencing the input buffer")
+{
+    PrinterMock printer;
+    PacketGenerator generator{52, printer};
+    PacketGenerator reference{52, printer};
+
+    auto buffer = generateRandomBuffer(1000);
+    Logi::EndPacketFlags flags{false, true, true};
+
+    auto views = generator.createPacketViews(buffer.data(), buffer.size(), flags);
+    auto packets = reference.createPackets(buffer, flags);
+    REQUIRE(views.size() == packets.size());
+    REQUIRE(views.size() == 19);
+
+    auto start = std::get<StartDataTransferPacket>(views.at(0));
+    CHECK(start.header.packetType == static_cast<uint8_t>(PacketType::StartDataTransfer));
+    CHECK(start.totalPayloadSize_0 == 0xE8);
+    CHECK(start.totalPayloadSize_1 == 0x03);
+
+    for (size_t i = 1; i < views.size() - 1; i++)
+    {
+        REQUIRE_NOTHROW(std::get<DataPacketView>(views.at(i)));
+        auto view = std::get<DataPacketView>(views.at(i));
+        auto packet = std::get<DataPacket>(packets.at(i));
+        CHECK(view.header.sequenceId_0 == packet.header.sequenceId_0);
+        CHECK(view.header.packetType == static_cast<uint8_t>(PacketType::Data));
+        CHECK(view.payloadSize == packet.payloadSize);
+        CHECK(view.data == buffer.data() + (i - 1) * PacketGenerator::s_maxDataBytes);
+    }
+
+    auto stop = std::get<StopDataTransferPacket>(views.back());
+    CHECK(stop.header.sequenceId_0 == 0x12);
+    CHECK(stop.flags == 0b00000011);
+
+    REQUIRE_CALL(printer, printBatch(ANY(const PrintBatch&))).TIMES(1);
+    generator.printPackets(views);
+}
+
+TEST_CASE("Stream packets one at a time")
+{
+    PrinterMock printer;
+    PacketGenerator generator{52, printer};
+    PacketGenerator reference{52, printer};
+
+    auto buffer = generateRandomBuffer(291);
+    Logi::EndPacketFlags flags{true, false, false};
+
+    PacketStream stream{generator, buffer.data(), buffer.size(), flags};
+    Packets streamed;
+    while (auto packet = stream.next())
+    {
+        streamed.emplace_back(*packet);
+    }
+    CHECK(stream.done());
+    CHECK_FALSE(stream.next().has_value());
+
+    auto packets = reference.createPackets(buffer, flags);
+    REQUIRE(streamed.size() == packets.size());
+    REQUIRE(streamed.size() == 7);
+
+    std::vector<std::byte> returnedPayload;
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+        REQUIRE(streamed.at(i).index() == packets.at(i).index());
+        std::visit([&](const auto& packet) {
+            using T = std::decay_t<decltype(packet)>;
+            const auto& expected = std::get<T>(packets.at(i));
+            CHECK(packet.header.sequenceId_0 == expected.header.sequenceId_0);
+            CHECK(packet.header.packetType == expected.header.packetType);
+            if constexpr (std::is_same_v<T, DataPacket>)
+                returnedPayload.insert(returnedPayload.end(), packet.data.begin(), packet.data.begin() + packet.payloadSize);
+        }, streamed.at(i));
+    }
+    CHECK(returnedPayload == buffer);
+    CHECK(std::get<StopDataTransferPacket>(streamed.back()).flags == 0b00000100);
+
+    // An empty transfer only has start and stop packets
+    PacketStream empty{generator, nullptr, 0, {}};
+    REQUIRE(empty.next().has_value());
+    auto stop = empty.next();
+    REQUIRE(stop.has_value());
+    CHECK(std::holds_alternative<StopDataTransferPacket>(*stop));
+    CHECK(empty.done());
+}
+
+TEST_CASE_METHOD(TestFixture, "Segment large inputs into several transfers")
+{
+    auto buffer = generateRandomBuffer(250);
+    auto packets = generator.createSegmentedPackets(buffer.data(), buffer.size(), {true, true, true}, 100);
+
+    // Transfers of 100, 100 and 50 bytes
+    REQUIRE(packets.size() == 11);
+    const std::vector<size_t> expectedTypes{0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 2};
+    std::vector<std::byte> returnedPayload;
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+        REQUIRE(packets.at(i).index() == expectedTypes.at(i));
+        std::visit([&](const auto& packet) {
+            CHECK(packet.header.sequenceId_0 == i);
+            if constexpr (std::is_same_v<std::decay_t<decltype(packet)>, DataPacket>)
+                returnedPayload.insert(returnedPayload.end(), packet.data.begin(), packet.data.begin() + packet.payloadSize);
+        }, packets.at(i));
+    }
+    CHECK(returnedPayload == buffer);
+
+    CHECK(std::get<StartDataTransferPacket>(packets.at(0)).totalPayloadSize_0 == 100);
+    CHECK(std::get<StartDataTransferPacket>(packets.at(4)).totalPayloadSize_0 == 100);
+    CHECK(std::get<StartDataTransferPacket>(packets.at(8)).totalPayloadSize_0 == 50);
+    CHECK(std::get<DataPacket>(packets.at(2)).payloadSize == 41);
+    CHECK(std::get<StopDataTransferPacket>(packets.at(3)).flags == 0);
+    CHECK(std::get<StopDataTransferPacket>(packets.at(7)).flags == 0);
+    CHECK(std::get<StopDataTransferPacket>(packets.at(10)).flags == 0b00000111);
+
+    // A single transfer cannot describe more than 4 GiB
+    size_t tooLarge = PacketGenerator::s_maxTransferBytes + 1;
+    CHECK_THROWS_AS(generator.createPackets(buffer.data(), tooLarge, {}), std::length_error);
+    CHECK_THROWS_AS(generator.createPacketViews(buffer.data(), tooLarge, {}), std::length_error);
+    CHECK_THROWS_AS(PacketStream(generator, buffer.data(), buffer.size(), {}, 0), std::invalid_argument);
+}
+
+TEST_CASE_METHOD(TestFixture, "Large inputs are one transfer by default")
+{
+    auto buffer = generateRandomBuffer(5 * 1024 * 1024);
+    auto countTransfers = [](auto&& nextPacket) {
+        size_t starts = 0;
+        size_t stops = 0;
+        while (auto packet = nextPacket())
+        {
+            starts += std::holds_alternative<StartDataTransferPacket>(*packet);
+            stops += std::holds_alternative<StopDataTransferPacket>(*packet);
+        }
+        return std::make_pair(starts, stops);
+    };
+
+    PacketStream stream{generator, buffer.data(), buffer.size(), {}};
+    CHECK(countTransfers([&] { return stream.next(); }) == std::make_pair<size_t, size_t>(1, 1));
+
+    auto packets = generator.createSegmentedPackets(buffer.data(), buffer.size(), {});
+    size_t index = 0;
+    CHECK(countTransfers([&] {
+        return index < packets.size() ? std::optional<PacketVariant>{packets[index++]} : std::nullopt;
+    }) == std::make_pair<size_t, size_t>(1, 1));
+}
+
+TEST_CASE_METHOD(TestFixture, "Sequence ids do not repeat within a unique sequence segment")
+{
+    auto buffer = generateRandomBuffer(2 * PacketGenerator::s_maxUniqueSequenceBytes + 100);
+    PacketStream stream{generator, buffer.data(), buffer.size(), {}, PacketGenerator::s_maxUniqueSequenceBytes};
+
+    // The first two transfers use every sequence id exactly once
+    std::vector<size_t> transferPackets;
+    std::vector<bool> seen;
+    bool unique = true;
+    while (auto packet = stream.next())
+    {
+        if (std::holds_alternative<StartDataTransferPacket>(*packet))
+        {
+            transferPackets.push_back(0);
+            seen.assign(0x10000, false);
+        }
+        auto sequenceId = std::visit([](const auto& packet) {
+            return PacketEncoder<Endianess::LittleEndian>::readSequenceId(packet.header);
+        }, *packet);
+        unique = unique && !seen.at(sequenceId);
+        seen.at(sequenceId) = true;
+        transferPackets.back()++;
+    }
+    CHECK(unique);
+    CHECK(transferPackets == std::vector<size_t>{0x10000, 0x10000, 4});
+}
+
+TEST_CASE("Serialize transfer in wire format")
+{
+    PrinterMock printer;
+    PacketGenerator generator{52, printer};
+    PacketGenerator reference{52, printer};
+
+    auto buffer = generateRandomBuffer(1000);
+    Logi::EndPacketFlags flags{true, false, true};
+
+    // 8 bytes start packet + 16 * (5 + 59) + (5 + 56) + 5 bytes stop packet
+    REQUIRE(PacketGenerator::serializedSize(buffer.size()) == 1098);
+    CHECK(PacketGenerator::serializedSize(0) == 13);
+
+    std::vector<std::byte> tooSmall(100);
+    CHECK_THROWS_AS(generator.serialize(buffer.data(), buffer.size(), flags, tooSmall.data(), tooSmall.size()), std::length_error);
+
+    auto serialized = generator.serialize(buffer, flags);
+    REQUIRE(serialized.size() == 1098);
+
+    // Must match the packets created field by field
+    std::vector<std::byte> expected;
+    for (const auto& packet : reference.createPackets(buffer, flags))
+    {
+        std::visit([&expected](const auto& p) {
+            std::byte bytes[64];
+            expected.insert(expected.end(), bytes, writePacket(bytes, p));
+        }, packet);
+    }
+    CHECK(serialized == expected);
+
+    CHECK(serialized.at(0) == std::byte{0x34});
+    CHECK(serialized.at(3) == std::byte{static_cast<uint8_t>(PacketType::StartDataTransfer)});
+    CHECK(serialized.at(4) == std::byte{0xE8});
+    CHECK(serialized.at(5) == std::byte{0x03});
+    CHECK(serialized.at(8 + 4) == std::byte{59});
+    CHECK(std::equal(buffer.begin(), buffer.begin() + 59, serialized.begin() + 13));
+    CHECK(serialized.back() == std::byte{0b00000101});
+}
+
+TEST_CASE("Generate seeded random buffers")
+{
+    auto buffer = generateRandomBuffer(1001, 42);
+    REQUIRE(buffer.size() == 1001);
+    CHECK(buffer == generateRandomBuffer(1001, 42));
+    CHECK(buffer != generateRandomBuffer(1001, 43));
+    CHECK(generateRandomBuffer(1001) != generateRandomBuffer(1001));
+
+    // A shorter buffer with the same seed is a prefix of the longer one
+    auto prefix = generateRandomBuffer(13, 42);
+    CHECK(std::equal(prefix.begin(), prefix.end(), buffer.begin()));
+
+    // Roughly uniform bytes
+    std::array<size_t, 256> histogram{};
+    for (auto byte : generateRandomBuffer(256 * 1024, 7))
+    {
+        histogram[std::to_integer<uint8_t>(byte)]++;
+    }
+    CHECK(*std::min_element(histogram.begin(), histogram.end()) > 850);
+    CHECK(*std::max_element(histogram.begin(), histogram.end()) < 1200);
+
+    CHECK(generateRandomFlags(64, 5) == generateRandomFlags(64, 5));
+    CHECK(generateRandomFlags(64, 5) != generateRandomFlags(64, 6));
+}
+
+TEST_CASE("Generate random slices independently")
+{
+    auto whole = generateRandomBuffer(10007, 99);
+
+    // Any slice matches the same range of the whole stream
+    for (uint64_t offset : {0, 1, 7, 8, 9, 4093})
+    {
+        auto slice = generateRandomBuffer(117, 99, offset);
+        CHECK(std::equal(slice.begin(), slice.end(), whole.begin() + offset));
+    }
+    CHECK(generateRandomBuffer(0, 99, 5).empty());
+
+    // Disjoint slices filled by several threads rebuild the whole buffer
+    std::vector<std::byte> parallel(whole.size());
+    std::vector<std::thread> workers;
+    const uint64_t sliceSize = 2501;
+    for (uint64_t offset = 0; offset < parallel.size(); offset += sliceSize)
+    {
+        auto size = std::min<uint64_t>(sliceSize, parallel.size() - offset);
+        workers.emplace_back(fillRandomBuffer, parallel.data() + offset, size, 99, offset);
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    CHECK(parallel == whole);
 }
 
 TEST_CASE("Test byte swap")
@@ -278,4 +701,25 @@ TEST_CASE("Test byte swap")
     uint32_t y = 291;
     y = byteSwap32(y);
     CHECK(y == 587268096);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Encode fields in compile-time byte order")
+{
+    PacketHeader header;
+    PacketEncoder<Endianess::LittleEndian>::writeSequenceId(header, 0x1234);
+    CHECK(header.sequenceId_0 == 0x34);
+    CHECK(header.sequenceId_1 == 0x12);
+    CHECK(PacketEncoder<Endianess::LittleEndian>::readSequenceId(header) == 0x1234);
+
+    PacketEncoder<Endianess::BigEndian>::writeSequenceId(header, 0x1234);
+    CHECK(header.sequenceId_0 == 0x12);
+    CHECK(header.sequenceId_1 == 0x34);
+    CHECK(PacketEncoder<Endianess::BigEndian>::readSequenceId(header) == 0x1234);
+
+    StartDataTransferPacket packet;
+    PacketEncoder<Endianess::BigEndian>::writeTotalPayloadSize(packet, 0xCAFE0123);
+    CHECK(packet.totalPayloadSize_0 == 0xCA);
+    CHECK(packet.totalPayloadSize_3 == 0x23);
+    CHECK(PacketEncoder<Endianess::BigEndian>::readTotalPayloadSize(packet) == 0xCAFE0123);
+    CHECK(readField32(packet.totalPayloadSize_0, packet.totalPayloadSize_1, packet.totalPayloadSize_2, packet.totalPayloadSize_3, true) == 0xCAFE0123);
+}
@@ -0,0 +1,68 @@
+#include "../src/NullPrinter.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/PacketValidator.hpp"
+#include "../src/Utils.hpp"
+#include "../src/WireFormat.hpp"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace Logi;
+
+namespace{
+    /// Serializes a transfer and keeps its data packets only.
+    std::vector<std::byte> serializeDataPackets(PacketGenerator& generator, size_t size)
+    {
+        auto serialized = generator.serialize(generateRandomBuffer(size, 6), {});
+        return {serialized.begin() + startPacketWireSize, serialized.end() - stopPacketWireSize};
+    }
+
+    size_t packetOffset(size_t index)
+    {
+        return index * maxPacketWireSize;
+    }
+}
+
+TEST_CASE("Validate serialized data packets")
+{
+    NullPrinter printer;
+    auto endianess = GENERATE(Endianess::LittleEndian, Endianess::BigEndian);
+    PacketGenerator generator{21, endianess, printer};
+    PacketValidator validator{21, endianess};
+
+    // 70000 packets, the sequence ids wrap around after 0xFFFF
+    auto packets = serializeDataPackets(generator, 70000 * maxPayloadSize - 10);
+    CHECK_FALSE(validator.findInvalidPacket(packets.data(), packets.size()).has_value());
+    CHECK_FALSE(validator.findInvalidPacket(packets.data(), 0).has_value());
+
+    SECTION("Unexpected software id")
+    {
+        packets.at(packetOffset(1234)) = std::byte{22};
+        CHECK(validator.findInvalidPacket(packets.data(), packets.size()) == 1234u);
+    }
+
+    SECTION("Unexpected packet type")
+    {
+        packets.at(packetOffset(69999) + 3) = std::byte{3};
+        CHECK(validator.findInvalidPacket(packets.data(), packets.size()) == 69999u);
+    }
+
+    SECTION("Sequence id gap")
+    {
+        packets.erase(packets.begin() + packetOffset(500), packets.begin() + packetOffset(501));
+        CHECK(validator.findInvalidPacket(packets.data(), packets.size()) == 500u);
+    }
+
+    SECTION("Payload size too large")
+    {
+        packets.at(packetOffset(7) + headerWireSize) = std::byte{60};
+        CHECK(validator.findInvalidPacket(packets.data(), packets.size()) == 7u);
+    }
+
+    SECTION("Truncated last packet")
+    {
+        CHECK(validator.findInvalidPacket(packets.data(), packets.size() - 1) == 69999u);
+        CHECK(validator.findInvalidPacket(packets.data(), packetOffset(3) + 2) == 3u);
+    }
+}
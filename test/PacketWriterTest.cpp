@@ -0,0 +1,94 @@
+#include "../src/NullPrinter.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/PacketWriter.hpp"
+#include "../src/Utils.hpp"
+#include "TemporaryPath.hpp"
+
+#include "catch.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace Logi;
+
+TEST_CASE("Write packets with gathered slices")
+{
+    NullPrinter printer;
+    PacketGenerator generator{52, printer};
+    PacketGenerator reference{52, printer};
+
+    // Several writev batches
+    auto buffer = generateRandomBuffer(100000);
+    auto expected = reference.serialize(buffer, {true, false, false});
+    auto packets = generator.createPacketViews(buffer.data(), buffer.size(), {true, false, false});
+
+    SECTION("To a file")
+    {
+        TemporaryPath path{"PacketWriterTest.bin"};
+        {
+            PacketWriter writer{path.str()};
+            CHECK(writer.write(packets) == expected.size());
+        }
+
+        std::ifstream file{path.str(), std::ios::binary};
+        std::vector<char> content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        REQUIRE(content.size() == expected.size());
+        CHECK(std::memcmp(content.data(), expected.data(), expected.size()) == 0);
+    }
+
+    SECTION("To a pipe")
+    {
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+
+        // The pipe holds less than a transfer, so writes are partial
+        std::vector<std::byte> content;
+        std::thread reader{[&] {
+            std::byte chunk[4096];
+            ssize_t size;
+            while ((size = ::read(fds[0], chunk, sizeof(chunk))) > 0)
+                content.insert(content.end(), chunk, chunk + size);
+        }};
+
+        {
+            PacketWriter writer{fds[1]};
+            CHECK(writer.write(packets) == expected.size());
+        }
+        ::close(fds[1]);
+        reader.join();
+        ::close(fds[0]);
+        CHECK(content == expected);
+    }
+
+    SECTION("Many empty transfers")
+    {
+        // Only headers, merged into a single slice, which fill the header arena first
+        PacketViews emptyTransfers;
+        std::vector<std::byte> expectedEmpty;
+        for (int transfer = 0; transfer < 3000; transfer++)
+        {
+            auto views = generator.createPacketViews(nullptr, 0, {});
+            emptyTransfers.insert(emptyTransfers.end(), views.begin(), views.end());
+            auto serialized = reference.serialize(std::vector<std::byte>{}, {});
+            expectedEmpty.insert(expectedEmpty.end(), serialized.begin(), serialized.end());
+        }
+
+        TemporaryPath path{"PacketWriterEmptyTest.bin"};
+        {
+            PacketWriter writer{path.str()};
+            CHECK(writer.write(emptyTransfers) == expectedEmpty.size());
+        }
+
+        std::ifstream file{path.str(), std::ios::binary};
+        std::vector<char> content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        REQUIRE(content.size() == expectedEmpty.size());
+        CHECK(std::memcmp(content.data(), expectedEmpty.data(), expectedEmpty.size()) == 0);
+    }
+
+    CHECK_THROWS_AS(PacketWriter("missing-directory/PacketWriterTest.bin"), std::system_error);
+}
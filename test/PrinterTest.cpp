@@ -0,0 +1,151 @@
+#include "../src/AsyncPrinter.hpp"
+#include "../src/FilePrinter.hpp"
+#include "../src/IPrinter.hpp"
+#include "TemporaryPath.hpp"
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+using namespace Logi;
+
+namespace{
+    class SlowPrinter : public IPrinter
+    {
+    public:
+        explicit SlowPrinter(std::chrono::microseconds delay) : m_delay{delay} {}
+
+        void print(std::string_view str) override
+        {
+            std::this_thread::sleep_for(m_delay);
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_lines.emplace_back(str);
+        }
+
+        std::vector<std::string> lines()
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            return m_lines;
+        }
+
+    private:
+        std::chrono::microseconds m_delay;
+        std::mutex m_mutex;
+        std::vector<std::string> m_lines;
+    };
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+}
+
+TEST_CASE("Async printer writes every record in order when blocking")
+{
+    SlowPrinter sink{std::chrono::microseconds(10)};
+    {
+        AsyncPrinter printer{sink, 8, AsyncPrinter::OverflowPolicy::Block};
+        for (int i = 0; i < 200; i++)
+        {
+            printer.print("record " + std::to_string(i));
+        }
+        printer.printBatch({"first\nsecond\n", {"first", "second"}});
+        printer.flush();
+
+        auto lines = sink.lines();
+        REQUIRE(lines.size() == 202);
+        CHECK(lines.at(0) == "record 0");
+        CHECK(lines.at(199) == "record 199");
+        CHECK(lines.at(201) == "second");
+        CHECK(printer.dropped() == 0);
+
+        printer.print("last");
+    }
+
+    // The destructor writes what is still queued
+    CHECK(sink.lines().back() == "last");
+}
+
+TEST_CASE("Idle async printer sleeps until records arrive")
+{
+    SlowPrinter sink{std::chrono::microseconds(0)};
+    AsyncPrinter printer{sink};
+    printer.print("first");
+    printer.flush();
+
+    // An idle writer thread blocks instead of polling the queue
+    rusage before;
+    ::getrusage(RUSAGE_SELF, &before);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    rusage after;
+    ::getrusage(RUSAGE_SELF, &after);
+    CHECK(after.ru_nvcsw - before.ru_nvcsw < 20);
+
+    // And is woken up by the next record
+    printer.print("second");
+    printer.flush();
+    CHECK(sink.lines().back() == "second");
+}
+
+TEST_CASE("Async printer drops records when the queue is full")
+{
+    SlowPrinter sink{std::chrono::milliseconds(1)};
+    AsyncPrinter printer{sink, 4, AsyncPrinter::OverflowPolicy::Drop};
+
+    for (int i = 0; i < 100; i++)
+    {
+        printer.print("record " + std::to_string(i));
+    }
+    printer.flush();
+
+    CHECK(printer.dropped() > 0);
+    CHECK(sink.lines().size() + printer.dropped() == 100);
+    CHECK(sink.lines().at(0) == "record 0");
+}
+
+TEST_CASE("File printer buffers records until flushed")
+{
+    TemporaryPath temporaryPath{"FilePrinterTest.txt"};
+    const auto& path = temporaryPath.str();
+    {
+        FilePrinter printer{path, 16};
+        printer.print("first");
+        printer.printBatch({"second\nthird\n", {"second", "third"}});
+        CHECK(readFile(path) == "first\n");  // the batch did not fit in the buffer
+
+        printer.flush();
+        CHECK(readFile(path) == "first\nsecond\nthird\n");
+
+        printer.print("a record larger than the buffer");
+        printer.print("last");
+    }
+
+    CHECK(readFile(path) == "first\nsecond\nthird\na record larger than the buffer\nlast\n");
+
+    CHECK_THROWS_AS(FilePrinter{"missing-directory/FilePrinterTest.txt"}, std::system_error);
+}
+
+TEST_CASE("Async printer hands the queued records to the sink as one text")
+{
+    TemporaryPath temporaryPath{"AsyncFilePrinterTest.txt"};
+    const auto& path = temporaryPath.str();
+    {
+        FilePrinter sink{path};
+        {
+            AsyncPrinter printer{sink};
+            printer.print("first");
+            printer.printBatch({"second\nthird\n", {"second", "third"}});
+        }
+    }
+
+    CHECK(readFile(path) == "first\nsecond\nthird\n");
+}
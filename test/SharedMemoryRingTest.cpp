@@ -0,0 +1,117 @@
+#include "../src/NullPrinter.hpp"
+#include "../src/PacketDecoder.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/SharedMemoryRing.hpp"
+#include "../src/Utils.hpp"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Logi;
+
+namespace{
+    std::string ringName()
+    {
+        return "/logi_packet_ring_test_" + std::to_string(::getpid());
+    }
+}
+
+TEST_CASE("Pass transfers between processes through a shared memory ring")
+{
+    // Smaller than a transfer, so both sides have to wait for each other
+    auto name = ringName();
+    auto ring = SharedMemoryRing::create(name, 4096);
+    // Larger than a unique sequence segment, still received as one transfer
+    const std::vector<size_t> sizes{0, 1, 59, 100000, PacketGenerator::s_maxUniqueSequenceBytes + 1000, 3000};
+
+    auto child = ::fork();
+    REQUIRE(child >= 0);
+    if (child == 0)
+    {
+        // Driver process: opens the ring by name and packetizes the transfers
+        int status = 0;
+        try
+        {
+            auto writerRing = SharedMemoryRing::open(name);
+            NullPrinter printer;
+            PacketGenerator generator{33, printer};
+            SharedMemorySink sink{writerRing};
+            for (auto size : sizes)
+            {
+                auto buffer = generateRandomBuffer(size, size);
+                if (sink.write(generator, buffer.data(), buffer.size(), {false, true, false}) != PacketGenerator::serializedSize(size))
+                    status = 1;
+            }
+            writerRing.close();
+        }
+        catch (...)
+        {
+            status = 2;
+        }
+        ::_exit(status);
+    }
+
+    PacketDecoder decoder{33};
+    SharedMemoryReader reader{ring, decoder};
+    for (auto size : sizes)
+    {
+        REQUIRE(reader.next());
+        CHECK(decoder.payload() == generateRandomBuffer(size, size));
+        CHECK(decoder.flags().verify);
+    }
+    CHECK_FALSE(reader.next());
+
+    int status = -1;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+}
+
+TEST_CASE("Shared memory ring names are exclusive")
+{
+    auto ring = SharedMemoryRing::create(ringName(), 64);
+    CHECK(ring.capacity() == 64);
+    CHECK_THROWS_AS(SharedMemoryRing::create(ringName(), 64), std::system_error);
+    CHECK_THROWS_AS(SharedMemoryRing::create(ringName() + "_empty", 0), std::invalid_argument);
+
+    // A shared memory object that was never initialized as a ring
+    auto raw = ringName() + "_raw";
+    auto fd = ::shm_open(raw.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    REQUIRE(fd >= 0);
+    CHECK(::ftruncate(fd, 4096) == 0);
+    ::close(fd);
+    CHECK_THROWS_AS(SharedMemoryRing::open(raw), std::runtime_error);
+    ::shm_unlink(raw.c_str());
+
+    // The creator removes the shared memory object
+    ring = SharedMemoryRing::create(ringName() + "_other", 64);
+    CHECK_THROWS_AS(SharedMemoryRing::open(ringName()), std::system_error);
+}
+
+TEST_CASE("Serialize in place up to the end of the ring")
+{
+    auto ring = SharedMemoryRing::create(ringName(), 64);
+    std::vector<std::byte> bytes(64);
+
+    size_t space = 0;
+    auto out = ring.reserve(10, space);
+    CHECK(space == 64);
+    std::fill_n(out, 60, std::byte{1});
+    ring.commit(60);
+    CHECK(ring.read(bytes.data(), bytes.size()) == 60);
+
+    // Only 4 bytes are left before the end of the ring, the rest wraps around
+    ring.reserve(10, space);
+    CHECK(space == 4);
+    const std::vector<std::byte> packet(10, std::byte{2});
+    ring.write(packet.data(), packet.size());
+    CHECK(ring.read(bytes.data(), bytes.size()) == packet.size());
+    CHECK(std::equal(packet.begin(), packet.end(), bytes.begin()));
+}
@@ -0,0 +1,164 @@
+#include "../src/NullPrinter.hpp"
+#include "../src/PacketDecoder.hpp"
+#include "../src/PacketGenerator.hpp"
+#include "../src/SocketSink.hpp"
+#include "../src/Utils.hpp"
+
+#include "catch.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <sys/socket.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace Logi;
+
+namespace{
+    /// Reads everything until end of file and decodes the transfers.
+    std::vector<std::vector<std::byte>> receiveTransfers(int fd, uint8_t softwareId)
+    {
+        PacketDecoder decoder{softwareId};
+        std::vector<std::vector<std::byte>> transfers;
+        std::vector<std::byte> pending;
+        std::byte chunk[4096];
+        ssize_t size;
+        while ((size = ::read(fd, chunk, sizeof(chunk))) > 0)
+        {
+            pending.insert(pending.end(), chunk, chunk + size);
+            size_t consumed;
+            while ((consumed = decoder.decode(pending.data(), pending.size())) > 0)
+            {
+                pending.erase(pending.begin(), pending.begin() + consumed);
+                if (decoder.done())
+                    transfers.push_back(decoder.payload());
+            }
+        }
+        return transfers;
+    }
+}
+
+TEST_CASE("Stream transfers over a Unix domain socket in large writes")
+{
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    std::vector<std::vector<std::byte>> received;
+    std::thread reader{[&] { received = receiveTransfers(fds[1], 44); }};
+
+    NullPrinter printer;
+    PacketGenerator generator{44, printer};
+    std::vector<std::vector<std::byte>> sent;
+    size_t written = 0;
+    {
+        SocketSink sink{fds[0], 4096, std::chrono::seconds(10)};
+        for (auto size : {0, 1, 100000, 59, 3000})
+        {
+            sent.push_back(generateRandomBuffer(size, size));
+            written += sink.write(generator, sent.back().data(), sent.back().size(), {});
+        }
+
+        // About one write per 4096 bytes rather than one per packet
+        CHECK(sink.writes() == written / 4096);
+    }
+    ::shutdown(fds[0], SHUT_WR);
+    reader.join();
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    CHECK(received == sent);
+}
+
+TEST_CASE("Pending packets are written once the latency cap expires")
+{
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    NullPrinter printer;
+    PacketGenerator generator{44, printer};
+    SocketSink sink{fds[0], SocketSink::s_defaultFlushBytes, std::chrono::milliseconds(20)};
+
+    auto buffer = generateRandomBuffer(10, 1);
+    auto written = sink.write(generator, buffer.data(), buffer.size(), {});
+    CHECK(written == PacketGenerator::serializedSize(buffer.size()));
+
+    std::byte received[256];
+    CHECK(::recv(fds[1], received, sizeof(received), MSG_DONTWAIT) < 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    sink.poll();
+    CHECK(static_cast<size_t>(::recv(fds[1], received, sizeof(received), MSG_DONTWAIT)) == written);
+    CHECK(sink.writes() == 1);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_CASE("Stream packets over a pipe")
+{
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+
+    std::vector<std::vector<std::byte>> received;
+    std::thread reader{[&] { received = receiveTransfers(fds[0], 45); }};
+
+    NullPrinter printer;
+    PacketGenerator generator{45, printer};
+    auto buffer = generateRandomBuffer(70000, 2);
+    {
+        SocketSink sink{fds[1]};
+        CHECK(sink.write(generator.createPackets(buffer, {})) == PacketGenerator::serializedSize(buffer.size()));
+    }
+    ::close(fds[1]);
+    reader.join();
+    ::close(fds[0]);
+
+    REQUIRE(received.size() == 1);
+    CHECK(received.front() == buffer);
+}
+
+TEST_CASE("Report a reader that is gone")
+{
+    NullPrinter printer;
+    PacketGenerator generator{46, printer};
+    auto buffer = generateRandomBuffer(100, 3);
+
+    auto checkBrokenPipe = [&](int fd) {
+        SocketSink sink{fd};
+        sink.write(generator, buffer.data(), buffer.size(), {});
+        try
+        {
+            sink.flush();
+            FAIL("the write succeeded");
+        }
+        catch (const std::system_error& error)
+        {
+            CHECK(error.code().value() == EPIPE);
+        }
+    };
+
+    SECTION("Socket")
+    {
+        int fds[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        ::close(fds[1]);
+        checkBrokenPipe(fds[0]);
+        ::close(fds[0]);
+    }
+
+    SECTION("Pipe, with SIGPIPE ignored by the caller")
+    {
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+        ::close(fds[0]);
+        auto previous = std::signal(SIGPIPE, SIG_IGN);
+        checkBrokenPipe(fds[1]);
+        std::signal(SIGPIPE, previous);
+        ::close(fds[1]);
+    }
+
+    CHECK_THROWS_AS(SocketSink{-1}, std::system_error);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+/// Path of a file in the temporary directory, removed when leaving the scope
+/// so that failing tests do not leave files behind.
+class TemporaryPath
+{
+public:
+
+    explicit TemporaryPath(const std::string& name)
+        : m_path{(std::filesystem::temp_directory_path() / ("logi_" + std::to_string(::getpid()) + "_" + name)).string()}
+    {}
+
+    ~TemporaryPath()
+    {
+        std::error_code error;
+        std::filesystem::remove(m_path, error);
+    }
+
+    TemporaryPath(const TemporaryPath&) = delete;
+    TemporaryPath& operator=(const TemporaryPath&) = delete;
+
+    const std::string& str() const { return m_path; }
+
+private:
+
+    std::string m_path;
+};